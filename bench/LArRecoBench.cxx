@@ -0,0 +1,457 @@
+/**
+ *  @file   LArReco/bench/LArRecoBench.cxx
+ *
+ *  @brief  Implementation of the LArReco benchmark application, running a versioned event sample through each detector configuration
+ *
+ *  $Log: $
+ */
+
+#include "Helpers/XmlHelper.h"
+#include "Pandora/StatusCodes.h"
+#include "Xml/tinyxml.h"
+
+#include "EventStatistics.h"
+#include "LArRecoBench.h"
+#include "SettingsHelper.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <getopt.h>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace pandora;
+using namespace lar_reco_bench;
+
+int main(int argc, char *argv[])
+{
+    int errorNo(0);
+    std::string workingDirectory;
+
+    try
+    {
+        BenchParameters parameters;
+
+        if (!ParseCommandLine(argc, argv, parameters))
+            return 1;
+
+        std::string sampleVersion;
+        BenchCaseList benchCaseList;
+        ReadManifest(parameters, sampleVersion, benchCaseList);
+
+        std::string baselineSampleVersion;
+        BenchResultMap baselineResultMap;
+
+        if (!parameters.m_baselineFileName.empty())
+        {
+            ReadResults(parameters.m_baselineFileName, baselineSampleVersion, baselineResultMap);
+
+            if (baselineSampleVersion != sampleVersion)
+            {
+                std::cout << "LArRecoBench, baseline sample version " << baselineSampleVersion << " does not match manifest sample version "
+                          << sampleVersion << std::endl;
+                return 1;
+            }
+        }
+
+        workingDirectory = lar_reco::SettingsHelper::CreateTemporaryDirectory();
+        BenchResultMap benchResultMap;
+
+        for (const BenchCase &benchCase : benchCaseList)
+        {
+            std::cout << "LArRecoBench, running " << benchCase.m_configurationName << " " << benchCase.m_recoOption << std::endl;
+            RunBenchCase(parameters, benchCase, workingDirectory, benchResultMap[BenchKey(benchCase.m_configurationName, benchCase.m_recoOption)]);
+        }
+
+        if (!parameters.m_outputFileName.empty())
+            WriteResults(parameters.m_outputFileName, sampleVersion, benchResultMap);
+
+        if (!CompareResults(parameters, benchResultMap, baselineResultMap))
+            errorNo = 2;
+    }
+    catch (const StatusCodeException &statusCodeException)
+    {
+        std::cerr << "Pandora StatusCodeException: " << statusCodeException.ToString() << std::endl;
+        errorNo = 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception: " << std::endl;
+        errorNo = 1;
+    }
+
+    lar_reco::SettingsHelper::RemoveDirectory(workingDirectory);
+
+    return errorNo;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco_bench
+{
+
+bool ParseCommandLine(int argc, char *argv[], BenchParameters &parameters)
+{
+    if (1 == argc)
+        return PrintOptions();
+
+    // ATTN Resolve the running executable, as argv[0] need not name its directory, e.g. when LArRecoBench is found via PATH
+    char executablePath[PATH_MAX];
+    const ssize_t pathLength(readlink("/proc/self/exe", executablePath, sizeof(executablePath)));
+    const bool isPathResolved((pathLength > 0) && (pathLength < static_cast<ssize_t>(sizeof(executablePath))));
+    const std::string programName(isPathResolved ? std::string(executablePath, pathLength) : std::string(argv[0]));
+    const std::string::size_type slashPosition(programName.find_last_of('/'));
+    parameters.m_executable = ((std::string::npos == slashPosition) ? std::string(".") : programName.substr(0, slashPosition)) + "/PandoraInterface";
+
+    int c(0);
+
+    while ((c = getopt(argc, argv, "m:d:x:b:o:c:T:L:M:h")) != -1)
+    {
+        switch (c)
+        {
+        case 'm':
+            parameters.m_manifestFileName = optarg;
+            break;
+        case 'd':
+            parameters.m_sampleDirectory = optarg;
+            break;
+        case 'x':
+            parameters.m_executable = optarg;
+            break;
+        case 'b':
+            parameters.m_baselineFileName = optarg;
+            break;
+        case 'o':
+            parameters.m_outputFileName = optarg;
+            break;
+        case 'c':
+            parameters.m_configurationName = optarg;
+            break;
+        case 'T':
+            parameters.m_throughputTolerance = atof(optarg);
+            break;
+        case 'L':
+            parameters.m_latencyTolerance = atof(optarg);
+            break;
+        case 'M':
+            parameters.m_memoryTolerance = atof(optarg);
+            break;
+        case 'h':
+        default:
+            return PrintOptions();
+        }
+    }
+
+    if (parameters.m_manifestFileName.empty() || parameters.m_sampleDirectory.empty())
+        return PrintOptions();
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool PrintOptions()
+{
+    std::cout << std::endl << "./bin/LArRecoBench " << std::endl
+              << "    -m Manifest            (required) [benchmark configurations, samples and reco options: xml]" << std::endl
+              << "    -d SampleDirectory     (required) [directory containing the versioned event samples, LArRecoBench_<Configuration>_<SampleVersion>.pndr,"
+              << " as listed in the manifest; the samples are not distributed with LArReco]" << std::endl
+              << "    -x Executable          (optional) [PandoraInterface executable, default alongside LArRecoBench]" << std::endl
+              << "    -b BaselineFile        (optional) [stored results against which to compare: xml]" << std::endl
+              << "    -o OutputFile          (optional) [file to receive the results, usable as a baseline: xml]" << std::endl
+              << "    -c Configuration       (optional) [run only the named configuration]" << std::endl
+              << "    -T ThroughputTolerance (optional) [tolerated fractional throughput loss, default 0.1]" << std::endl
+              << "    -L LatencyTolerance    (optional) [tolerated fractional latency percentile increase, default 0.1]" << std::endl
+              << "    -M MemoryTolerance     (optional) [tolerated fractional peak memory increase, default 0.1]" << std::endl << std::endl;
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ReadManifest(const BenchParameters &parameters, std::string &sampleVersion, BenchCaseList &benchCaseList)
+{
+    TiXmlDocument xmlDocument(parameters.m_manifestFileName);
+
+    if (!xmlDocument.LoadFile())
+    {
+        std::cout << "LArRecoBench, invalid manifest " << parameters.m_manifestFileName << ", " << xmlDocument.ErrorDesc() << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    const TiXmlHandle xmlHandle(xmlDocument.RootElement());
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "SampleVersion", sampleVersion));
+
+    int nEvents(0);
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "NEvents", nEvents));
+
+    const std::string::size_type slashPosition(parameters.m_manifestFileName.find_last_of('/'));
+    const std::string manifestDirectory((std::string::npos == slashPosition) ? "." : parameters.m_manifestFileName.substr(0, slashPosition));
+
+    for (TiXmlElement *pElement = xmlHandle.FirstChild("Configuration").Element(); nullptr != pElement; pElement = pElement->NextSiblingElement("Configuration"))
+    {
+        const char *const pName(pElement->Attribute("name"));
+
+        if (!pName)
+            throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+        if (!parameters.m_configurationName.empty() && (parameters.m_configurationName != pName))
+            continue;
+
+        const TiXmlHandle configurationHandle(pElement);
+        std::string settingsFile, geometryFile, eventFile;
+        StringVector recoOptions;
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(configurationHandle, "SettingsFile", settingsFile));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(configurationHandle, "GeometryFile", geometryFile));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(configurationHandle, "EventFile", eventFile));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadVectorOfValues(configurationHandle, "RecoOptions", recoOptions));
+
+        for (const std::string &recoOption : recoOptions)
+        {
+            BenchCase benchCase;
+            benchCase.m_configurationName = pName;
+            benchCase.m_settingsFile = manifestDirectory + "/" + settingsFile;
+            benchCase.m_geometryFile = manifestDirectory + "/" + geometryFile;
+            benchCase.m_eventFile = parameters.m_sampleDirectory + "/" + eventFile;
+            benchCase.m_recoOption = recoOption;
+            benchCase.m_nEvents = nEvents;
+            benchCaseList.push_back(benchCase);
+        }
+    }
+
+    if (benchCaseList.empty())
+    {
+        std::cout << "LArRecoBench, no benchmark cases selected from manifest " << parameters.m_manifestFileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void RunBenchCase(const BenchParameters &parameters, const BenchCase &benchCase, const std::string &workingDirectory, BenchResult &benchResult)
+{
+    const std::string caseName(benchCase.m_configurationName + "_" + benchCase.m_recoOption);
+    const std::string eventLogFileName(workingDirectory + "/" + caseName + ".csv");
+    const std::string outputLogFileName(workingDirectory + "/" + caseName + ".log");
+
+    const std::string::size_type slashPosition(benchCase.m_settingsFile.find_last_of('/'));
+    const std::string settingsDirectory(benchCase.m_settingsFile.substr(0, slashPosition));
+    const char *const pFileSearchPath(std::getenv("FW_SEARCH_PATH"));
+    const std::string fileSearchPath(settingsDirectory + (pFileSearchPath ? std::string(":") + pFileSearchPath : std::string()));
+
+    const std::vector<std::string> arguments{parameters.m_executable, "-r", benchCase.m_recoOption, "-i", benchCase.m_settingsFile, "-g",
+        benchCase.m_geometryFile, "-e", benchCase.m_eventFile, "-n", std::to_string(benchCase.m_nEvents), "-l", eventLogFileName};
+
+    // ATTN Throughput is measured over the wall time of the whole run, so it also reflects initialisation, input stalls and any time between events
+    const auto startTime(std::chrono::steady_clock::now());
+    const pid_t pid(fork());
+
+    if (pid < 0)
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+
+    if (0 == pid)
+    {
+        // ATTN Worker settings files are located via FW_SEARCH_PATH, so the directory of the master settings file is searched first
+        const int outputFd(open(outputLogFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+
+        if ((outputFd < 0) || (dup2(outputFd, STDOUT_FILENO) < 0) || (dup2(outputFd, STDERR_FILENO) < 0) ||
+            (0 != setenv("FW_SEARCH_PATH", fileSearchPath.c_str(), 1)))
+        {
+            _exit(127);
+        }
+
+        std::vector<char *> argv;
+
+        for (const std::string &argument : arguments)
+            argv.push_back(const_cast<char *>(argument.c_str()));
+
+        argv.push_back(nullptr);
+        execv(argv.front(), argv.data());
+        _exit(127);
+    }
+
+    int status(0);
+    struct rusage resourceUsage;
+
+    if (wait4(pid, &status, 0, &resourceUsage) != pid)
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+
+    const std::chrono::duration<double> wallTime(std::chrono::steady_clock::now() - startTime);
+
+    if (!WIFEXITED(status) || (0 != WEXITSTATUS(status)))
+    {
+        std::cout << "LArRecoBench, " << caseName << " failed, see output below" << std::endl << std::ifstream(outputLogFileName).rdbuf() << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    std::ifstream eventLogFile(eventLogFileName);
+    std::string line;
+    std::getline(eventLogFile, line);
+
+    // ATTN Locate columns by name, counted from the end of each line in case file names (the first column) contain commas
+    StringVector columnNames;
+    XmlHelper::TokenizeString(line, columnNames, ",");
+
+    const auto processTimeIter(std::find(columnNames.begin(), columnNames.end(), "ProcessTime"));
+    const auto resetTimeIter(std::find(columnNames.begin(), columnNames.end(), "ResetTime"));
+
+    if ((columnNames.end() == processTimeIter) || (columnNames.end() == resetTimeIter))
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+
+    const std::size_t processTimeFromEnd(columnNames.end() - processTimeIter), resetTimeFromEnd(columnNames.end() - resetTimeIter);
+
+    std::vector<double> sortedTimes;
+
+    while (std::getline(eventLogFile, line))
+    {
+        StringVector tokens;
+        XmlHelper::TokenizeString(line, tokens, ",");
+
+        if (tokens.size() < columnNames.size())
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+
+        const double eventTime(std::stod(tokens.at(tokens.size() - processTimeFromEnd)) + std::stod(tokens.at(tokens.size() - resetTimeFromEnd)));
+        sortedTimes.push_back(eventTime);
+    }
+
+    std::sort(sortedTimes.begin(), sortedTimes.end());
+
+    benchResult.m_nEvents = sortedTimes.size();
+    benchResult.m_throughput = (wallTime.count() > 0.) ? sortedTimes.size() / wallTime.count() : 0.;
+    benchResult.m_latencyP50 = lar_reco::EventStatistics::GetPercentile(sortedTimes, 50.);
+    benchResult.m_latencyP95 = lar_reco::EventStatistics::GetPercentile(sortedTimes, 95.);
+    benchResult.m_latencyP99 = lar_reco::EventStatistics::GetPercentile(sortedTimes, 99.);
+    benchResult.m_peakMemory = resourceUsage.ru_maxrss;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ReadResults(const std::string &fileName, std::string &sampleVersion, BenchResultMap &benchResultMap)
+{
+    TiXmlDocument xmlDocument(fileName);
+
+    if (!xmlDocument.LoadFile())
+    {
+        std::cout << "LArRecoBench, invalid results file " << fileName << ", " << xmlDocument.ErrorDesc() << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    const TiXmlHandle xmlHandle(xmlDocument.RootElement());
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "SampleVersion", sampleVersion));
+
+    for (TiXmlElement *pElement = xmlHandle.FirstChild("Result").Element(); nullptr != pElement; pElement = pElement->NextSiblingElement("Result"))
+    {
+        const TiXmlHandle resultHandle(pElement);
+        std::string configurationName, recoOption;
+        BenchResult benchResult;
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(resultHandle, "Configuration", configurationName));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(resultHandle, "RecoOption", recoOption));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(resultHandle, "NEvents", benchResult.m_nEvents));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(resultHandle, "Throughput", benchResult.m_throughput));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(resultHandle, "LatencyP50", benchResult.m_latencyP50));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(resultHandle, "LatencyP95", benchResult.m_latencyP95));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(resultHandle, "LatencyP99", benchResult.m_latencyP99));
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(resultHandle, "PeakMemory", benchResult.m_peakMemory));
+        benchResultMap[BenchKey(configurationName, recoOption)] = benchResult;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void WriteResults(const std::string &fileName, const std::string &sampleVersion, const BenchResultMap &benchResultMap)
+{
+    std::ofstream outputFile(fileName);
+
+    if (!outputFile)
+    {
+        std::cout << "LArRecoBench, unable to open output file " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    outputFile << std::setprecision(9) << "<LArRecoBenchResults>" << std::endl << "    <SampleVersion>" << sampleVersion << "</SampleVersion>" << std::endl;
+
+    for (const auto &mapEntry : benchResultMap)
+    {
+        const BenchResult &benchResult(mapEntry.second);
+        outputFile << "    <Result>" << std::endl
+                   << "        <Configuration>" << mapEntry.first.first << "</Configuration>" << std::endl
+                   << "        <RecoOption>" << mapEntry.first.second << "</RecoOption>" << std::endl
+                   << "        <NEvents>" << benchResult.m_nEvents << "</NEvents>" << std::endl
+                   << "        <Throughput>" << benchResult.m_throughput << "</Throughput>" << std::endl
+                   << "        <LatencyP50>" << benchResult.m_latencyP50 << "</LatencyP50>" << std::endl
+                   << "        <LatencyP95>" << benchResult.m_latencyP95 << "</LatencyP95>" << std::endl
+                   << "        <LatencyP99>" << benchResult.m_latencyP99 << "</LatencyP99>" << std::endl
+                   << "        <PeakMemory>" << benchResult.m_peakMemory << "</PeakMemory>" << std::endl
+                   << "    </Result>" << std::endl;
+    }
+
+    outputFile << "</LArRecoBenchResults>" << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool CompareResults(const BenchParameters &parameters, const BenchResultMap &benchResultMap, const BenchResultMap &baselineResultMap)
+{
+    bool withinTolerance(true);
+
+    std::ostringstream report;
+    report << std::endl << "LArRecoBench, results" << std::endl << std::fixed << std::setprecision(3);
+
+    for (const auto &mapEntry : benchResultMap)
+    {
+        const BenchResult &benchResult(mapEntry.second);
+        report << "    " << std::left << std::setw(16) << mapEntry.first.first << std::setw(18) << mapEntry.first.second << std::right
+               << benchResult.m_nEvents << " events, " << benchResult.m_throughput << " events/s, p50/p95/p99 " << benchResult.m_latencyP50 << "/"
+               << benchResult.m_latencyP95 << "/" << benchResult.m_latencyP99 << " s, peak " << benchResult.m_peakMemory << " kB" << std::endl;
+
+        if (baselineResultMap.empty())
+            continue;
+
+        const auto baselineIter(baselineResultMap.find(mapEntry.first));
+
+        if (baselineResultMap.end() == baselineIter)
+        {
+            report << "        no baseline" << std::endl;
+            continue;
+        }
+
+        const BenchResult &baselineResult(baselineIter->second);
+        StringVector regressions;
+
+        if (benchResult.m_nEvents != baselineResult.m_nEvents)
+            regressions.push_back("event count " + std::to_string(benchResult.m_nEvents) + " vs " + std::to_string(baselineResult.m_nEvents));
+
+        if (benchResult.m_throughput < baselineResult.m_throughput * (1. - parameters.m_throughputTolerance))
+            regressions.push_back("throughput vs " + std::to_string(baselineResult.m_throughput) + " events/s");
+
+        if ((benchResult.m_latencyP50 > baselineResult.m_latencyP50 * (1. + parameters.m_latencyTolerance)) ||
+            (benchResult.m_latencyP95 > baselineResult.m_latencyP95 * (1. + parameters.m_latencyTolerance)) ||
+            (benchResult.m_latencyP99 > baselineResult.m_latencyP99 * (1. + parameters.m_latencyTolerance)))
+        {
+            regressions.push_back("latency vs p50/p95/p99 " + std::to_string(baselineResult.m_latencyP50) + "/" +
+                std::to_string(baselineResult.m_latencyP95) + "/" + std::to_string(baselineResult.m_latencyP99) + " s");
+        }
+
+        if (benchResult.m_peakMemory > baselineResult.m_peakMemory * (1. + parameters.m_memoryTolerance))
+            regressions.push_back("peak memory vs " + std::to_string(baselineResult.m_peakMemory) + " kB");
+
+        for (const std::string &regression : regressions)
+            report << "        REGRESSION: " << regression << std::endl;
+
+        withinTolerance = withinTolerance && regressions.empty();
+    }
+
+    std::cout << report.str() << std::endl;
+
+    return withinTolerance;
+}
+
+} // namespace lar_reco_bench
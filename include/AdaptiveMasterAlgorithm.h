@@ -0,0 +1,59 @@
+/**
+ *  @file   LArReco/include/AdaptiveMasterAlgorithm.h
+ *
+ *  @brief  Header file for the adaptive master algorithm class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_ADAPTIVE_MASTER_ALGORITHM_H
+#define LAR_RECO_ADAPTIVE_MASTER_ALGORITHM_H 1
+
+#include "Pandora/Algorithm.h"
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  AdaptiveMasterAlgorithm class, choosing a reconstruction path for each event from its hit counts per view and per TPC volume.
+ *          Each path is a daughter LArMaster, configured with its own steering flags. The paths are considered in turn, and the first path
+ *          whose thresholds are not exceeded is run, with the last path (which has no thresholds) run for all remaining events.
+ */
+class AdaptiveMasterAlgorithm : public pandora::Algorithm
+{
+public:
+    /**
+     *  @brief  Factory class for instantiating algorithm
+     */
+    class Factory : public pandora::AlgorithmFactory
+    {
+    public:
+        pandora::Algorithm *CreateAlgorithm() const;
+    };
+
+    /**
+     *  @brief  Default constructor
+     */
+    AdaptiveMasterAlgorithm();
+
+private:
+    pandora::StatusCode Run();
+    pandora::StatusCode ReadSettings(const pandora::TiXmlHandle xmlHandle);
+
+    pandora::StringVector   m_caloHitListNames;         ///< The names of the calo hit lists to count, one per view
+    pandora::StringVector   m_pathAlgorithmNames;       ///< The names of the daughter LArMaster algorithms, one per reconstruction path
+    pandora::StringVector   m_pathNames;                ///< The names of the reconstruction paths, used to log the chosen path
+    pandora::IntVector      m_maxHitsPerView;           ///< The maximum hit count in any view for each path, other than the last
+    pandora::IntVector      m_maxHitsPerVolume;         ///< The maximum hit count in any TPC volume for each path, other than the last
+    bool                    m_shouldPrintChosenPath;    ///< Whether to print the hit counts and the chosen path for each event
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline pandora::Algorithm *AdaptiveMasterAlgorithm::Factory::CreateAlgorithm() const
+{
+    return new AdaptiveMasterAlgorithm();
+}
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_ADAPTIVE_MASTER_ALGORITHM_H
@@ -0,0 +1,182 @@
+/**
+ *  @file   LArReco/include/AlgorithmProfiler.h
+ *
+ *  @brief  Header file for the algorithm profiler class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_ALGORITHM_PROFILER_H
+#define LAR_RECO_ALGORITHM_PROFILER_H 1
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  AlgorithmProfiler class, accumulating the wall time, call count and allocation count for each profiled algorithm.
+ *          Algorithms are identified by their nesting path (e.g. LArMaster/LArClusteringParent/LArTrackClusterCreation), so that
+ *          daughter algorithms and the algorithms run by LArMaster worker instances are reported separately from their parents.
+ */
+class AlgorithmProfiler
+{
+public:
+    /**
+     *  @brief  ProfileEntry class, describing the resources used by a single algorithm path
+     */
+    class ProfileEntry
+    {
+    public:
+        /**
+         *  @brief  Default constructor
+         */
+        ProfileEntry();
+
+        /**
+         *  @brief  Add the contents of another profile entry to this entry
+         *
+         *  @param  other the other profile entry
+         */
+        void Add(const ProfileEntry &other);
+
+        unsigned long long  m_nCalls;                   ///< The number of calls to the algorithm
+        double              m_inclusiveTime;            ///< The wall time, including daughter algorithms, units s
+        double              m_exclusiveTime;            ///< The wall time, excluding daughter algorithms, units s
+        unsigned long long  m_nAllocations;             ///< The number of heap allocations, including daughter algorithms
+        unsigned long long  m_nExclusiveAllocations;    ///< The number of heap allocations, excluding daughter algorithms
+    };
+
+    typedef std::map<std::string, ProfileEntry> ProfileMap;
+
+    /**
+     *  @brief  Scope class, profiling a single algorithm call for its lifetime
+     */
+    class Scope
+    {
+    public:
+        /**
+         *  @brief  Constructor, starting the profiling of an algorithm call on the calling thread
+         *
+         *  @param  algorithmType the type of the profiled algorithm
+         */
+        Scope(const std::string &algorithmType);
+
+        /**
+         *  @brief  Destructor, recording the resources used by the algorithm call
+         */
+        ~Scope();
+
+        /**
+         *  @brief  Deleted copy constructor
+         */
+        Scope(const Scope &) = delete;
+
+        /**
+         *  @brief  Deleted assignment operator
+         */
+        Scope &operator=(const Scope &) = delete;
+    };
+
+    /**
+     *  @brief  Get the profiler singleton
+     *
+     *  @return the profiler
+     */
+    static AlgorithmProfiler &GetInstance();
+
+    /**
+     *  @brief  Set whether to retain a separate breakdown for every event, in addition to the totals across all events
+     *
+     *  @param  shouldStoreEvents whether to store per-event breakdowns
+     */
+    void SetShouldStoreEvents(const bool shouldStoreEvents);
+
+    /**
+     *  @brief  Mark the end of an event on the calling thread, folding its algorithm profiles into the run totals
+     *
+     *  @param  eventFileNameList the colon-separated list of files from which the event was read
+     *  @param  eventNumber the event number
+     */
+    void EndEvent(const std::string &eventFileNameList, const int eventNumber);
+
+    /**
+     *  @brief  Write the profiling report, in json format if the file name has a .json extension and in csv format otherwise
+     *
+     *  @param  fileName the output file name
+     */
+    void WriteReport(const std::string &fileName) const;
+
+    /**
+     *  @brief  Clear the run totals, the per-event breakdowns and any partial event profile on the calling thread, e.g. between daemon jobs
+     */
+    void Reset();
+
+private:
+    /**
+     *  @brief  EventProfile class, describing the algorithm profiles for a single event
+     */
+    class EventProfile
+    {
+    public:
+        std::string         m_eventFileNameList;        ///< The colon-separated list of files from which the event was read
+        int                 m_eventNumber;              ///< The event number
+        ProfileMap          m_profileMap;               ///< The algorithm profiles for the event
+    };
+
+    typedef std::vector<EventProfile> EventProfileList;
+
+    /**
+     *  @brief  Default constructor
+     */
+    AlgorithmProfiler();
+
+    /**
+     *  @brief  Write the report in csv format
+     *
+     *  @param  fileName the output file name
+     */
+    void WriteCsvReport(const std::string &fileName) const;
+
+    /**
+     *  @brief  Write the report in json format
+     *
+     *  @param  fileName the output file name
+     */
+    void WriteJsonReport(const std::string &fileName) const;
+
+    mutable std::mutex      m_mutex;                    ///< The mutex protecting the run totals from concurrent event-parallel threads
+    bool                    m_shouldStoreEvents;        ///< Whether to store per-event breakdowns
+    unsigned int            m_nEvents;                  ///< The number of events profiled
+    ProfileMap              m_profileMap;               ///< The algorithm profiles, summed over all events
+    EventProfileList        m_eventProfileList;         ///< The per-event algorithm profiles
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline AlgorithmProfiler::ProfileEntry::ProfileEntry() :
+    m_nCalls(0),
+    m_inclusiveTime(0.),
+    m_exclusiveTime(0.),
+    m_nAllocations(0),
+    m_nExclusiveAllocations(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline void AlgorithmProfiler::ProfileEntry::Add(const ProfileEntry &other)
+{
+    m_nCalls += other.m_nCalls;
+    m_inclusiveTime += other.m_inclusiveTime;
+    m_exclusiveTime += other.m_exclusiveTime;
+    m_nAllocations += other.m_nAllocations;
+    m_nExclusiveAllocations += other.m_nExclusiveAllocations;
+}
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_ALGORITHM_PROFILER_H
@@ -0,0 +1,30 @@
+/**
+ *  @file   LArReco/include/AllocationCounter.h
+ *
+ *  @brief  Header file for the allocation counter, which tracks the heap allocations made by each thread.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_ALLOCATION_COUNTER_H
+#define LAR_RECO_ALLOCATION_COUNTER_H 1
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  AllocationCounter class, reading the counts maintained by the replacement global operator new
+ */
+class AllocationCounter
+{
+public:
+    /**
+     *  @brief  Get the number of heap allocations made so far by the calling thread
+     *
+     *  @return the number of allocations
+     */
+    static unsigned long long GetThreadAllocationCount();
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_ALLOCATION_COUNTER_H
@@ -0,0 +1,128 @@
+/**
+ *  @file   LArReco/include/BinaryGeometry.h
+ *
+ *  @brief  Header file for the binary geometry class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_BINARY_GEOMETRY_H
+#define LAR_RECO_BINARY_GEOMETRY_H 1
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pandora {class Pandora;}
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  BinaryGeometry class, a read-only memory mapping of a compact binary geometry file. The file holds a header followed by fixed-size
+ *          LArTPC and LineGap records, so it is read in place without parsing, and its pages are shared via the page cache by all processes
+ *          on a node. Each pandora instance still holds its own copy of the geometry objects, created from the records by CreateGeometry.
+ */
+class BinaryGeometry
+{
+public:
+    /**
+     *  @brief  Constructor, mapping a binary geometry file into memory
+     *
+     *  @param  fileName the binary geometry file name
+     */
+    BinaryGeometry(const std::string &fileName);
+
+    /**
+     *  @brief  Destructor, unmapping the file
+     */
+    ~BinaryGeometry();
+
+    /**
+     *  @brief  Deleted copy constructor
+     */
+    BinaryGeometry(const BinaryGeometry &) = delete;
+
+    /**
+     *  @brief  Deleted assignment operator
+     */
+    BinaryGeometry &operator=(const BinaryGeometry &) = delete;
+
+    /**
+     *  @brief  Create the LArTPC and LineGap geometry objects described by the file in a pandora instance, which owns its own copies
+     *
+     *  @param  pandora the pandora instance
+     */
+    void CreateGeometry(const pandora::Pandora &pandora) const;
+
+    /**
+     *  @brief  Whether a file is in the binary geometry format, as identified by its leading magic number
+     *
+     *  @param  fileName the file name
+     *
+     *  @return boolean
+     */
+    static bool IsBinaryGeometryFile(const std::string &fileName);
+
+    /**
+     *  @brief  Convert an xml geometry description (LArTPC and LineGap elements) to the binary geometry format
+     *
+     *  @param  xmlFileName the input xml geometry file name
+     *  @param  binaryFileName the output binary geometry file name
+     */
+    static void ConvertXmlGeometry(const std::string &xmlFileName, const std::string &binaryFileName);
+
+private:
+    /**
+     *  @brief  FileHeader class, the fixed-size header at the start of a binary geometry file
+     */
+    class FileHeader
+    {
+    public:
+        char                m_magic[8];                 ///< The magic number identifying the format
+        std::uint32_t       m_version;                  ///< The format version
+        std::uint32_t       m_nLArTPCs;                 ///< The number of LArTPC records
+        std::uint32_t       m_nLineGaps;                ///< The number of LineGap records
+        std::uint32_t       m_reserved;                 ///< Padding, reserved for future use
+    };
+
+    /**
+     *  @brief  LArTPCRecord class, describing a single LArTPC volume
+     */
+    class LArTPCRecord
+    {
+    public:
+        std::uint32_t       m_larTPCVolumeId;           ///< The LArTPC volume id
+        float               m_center[3];                ///< The center x, y, z coordinates
+        float               m_width[3];                 ///< The x, y, z widths
+        float               m_wirePitch[3];             ///< The u, v, w wire pitches
+        float               m_wireAngle[3];             ///< The u, v, w wire angles
+        float               m_sigmaUVW;                 ///< The uvw coordinate resolution
+        std::uint32_t       m_isDriftInPositiveX;       ///< Whether the drift direction is towards positive x
+    };
+
+    /**
+     *  @brief  LineGapRecord class, describing a single line gap
+     */
+    class LineGapRecord
+    {
+    public:
+        std::uint32_t       m_lineGapType;              ///< The line gap type
+        float               m_lineStartX;               ///< The line start x coordinate
+        float               m_lineEndX;                 ///< The line end x coordinate
+        float               m_lineStartZ;               ///< The line start z coordinate
+        float               m_lineEndZ;                 ///< The line end z coordinate
+    };
+
+    static const char           m_magicNumber[8];       ///< The magic number identifying the binary geometry format
+    static const std::uint32_t  m_formatVersion;        ///< The current format version
+
+    void                       *m_pAddress;             ///< The address of the memory mapping
+    std::size_t                 m_size;                 ///< The size of the memory mapping
+    const FileHeader           *m_pFileHeader;          ///< The address of the file header
+    const LArTPCRecord         *m_pLArTPCRecords;       ///< The address of the first LArTPC record
+    const LineGapRecord        *m_pLineGapRecords;      ///< The address of the first LineGap record
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_BINARY_GEOMETRY_H
@@ -0,0 +1,130 @@
+/**
+ *  @file   LArReco/include/CompressedEventFile.h
+ *
+ *  @brief  Header file for the compressed event file class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_COMPRESSED_EVENT_FILE_H
+#define LAR_RECO_COMPRESSED_EVENT_FILE_H 1
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  CompressedEventFile class, providing conversion between binary (.pndr) event files and their block-compressed (.pndz) variant.
+ *          Each container in the binary file is compressed independently (zstd), so blocks can be decompressed in parallel, and in any order.
+ */
+class CompressedEventFile
+{
+public:
+    /**
+     *  @brief  Block class, describing a single compressed container
+     */
+    class Block
+    {
+    public:
+        std::uint64_t       m_offset;               ///< The byte offset of the compressed data in the compressed file
+        std::uint64_t       m_compressedSize;       ///< The size of the compressed data, units bytes
+        std::uint64_t       m_outputOffset;         ///< The byte offset of the container in the decompressed (binary) file
+        std::uint64_t       m_outputSize;           ///< The size of the container in the decompressed (binary) file, units bytes
+        bool                m_isEventContainer;     ///< Whether the container holds an event
+    };
+
+    typedef std::vector<Block> BlockList;
+
+    /**
+     *  @brief  Whether a file is a compressed event file, as identified by the .pndz extension
+     *
+     *  @param  fileName the file name
+     *
+     *  @return boolean
+     */
+    static bool IsCompressedFile(const std::string &fileName);
+
+    /**
+     *  @brief  Get the unqualified name of the binary event file corresponding to a compressed event file
+     *
+     *  @param  fileName the compressed event file name
+     *
+     *  @return the unqualified binary event file name
+     */
+    static std::string GetBinaryBaseName(const std::string &fileName);
+
+    /**
+     *  @brief  Compress a binary event file, container by container
+     *
+     *  @param  inputFileName the binary event file name
+     *  @param  outputFileName the compressed event file name
+     *  @param  compressionLevel the zstd compression level
+     */
+    static void Compress(const std::string &inputFileName, const std::string &outputFileName, const int compressionLevel);
+
+    /**
+     *  @brief  Read the block headers of a compressed event file
+     *
+     *  @param  fileName the compressed event file name
+     *  @param  blockList to receive the blocks, in file order
+     */
+    static void ReadBlocks(const std::string &fileName, BlockList &blockList);
+
+    /**
+     *  @brief  Decompress a compressed event file to a binary event file, sharing the blocks between a number of threads. The output is
+     *          written alongside, then renamed into place, so that a reader never sees a partial file.
+     *
+     *  @param  inputFileName the compressed event file name
+     *  @param  blockList the blocks of the compressed event file
+     *  @param  outputFileName the binary event file name
+     *  @param  nThreads the number of decompression threads
+     */
+    static void Decompress(const std::string &inputFileName, const BlockList &blockList, const std::string &outputFileName, const unsigned int nThreads);
+
+private:
+    /**
+     *  @brief  FileHeader class, the fixed-size header at the start of a compressed event file
+     */
+    class FileHeader
+    {
+    public:
+        char                m_magic[8];             ///< The magic number identifying the format
+        std::uint32_t       m_version;              ///< The format version
+        std::int32_t        m_compressionLevel;     ///< The zstd compression level used
+        std::uint64_t       m_nBlocks;              ///< The number of blocks
+    };
+
+    /**
+     *  @brief  BlockHeader class, the fixed-size header preceding the compressed data for each block
+     */
+    class BlockHeader
+    {
+    public:
+        std::uint64_t       m_compressedSize;       ///< The size of the compressed data, units bytes
+        std::uint64_t       m_uncompressedSize;     ///< The size of the decompressed container, units bytes
+        std::uint32_t       m_isEventContainer;     ///< Whether the container holds an event
+        std::uint32_t       m_padding;              ///< Padding, for alignment
+    };
+
+    /**
+     *  @brief  Decompress the blocks claimed in turn from a shared counter, writing each container at its offset in the output file
+     *
+     *  @param  inputFd the compressed event file descriptor
+     *  @param  blockList the blocks
+     *  @param  outputFd the binary event file descriptor
+     *  @param  nextBlock the shared counter giving the next unclaimed block
+     *  @param  success the shared success flag, cleared on any failure
+     */
+    static void DecompressBlocks(const int inputFd, const BlockList &blockList, const int outputFd, std::atomic<std::size_t> &nextBlock,
+        std::atomic<bool> &success);
+
+    static const char           m_magicNumber[8];       ///< The magic number identifying the compressed event file format
+    static const std::uint32_t  m_formatVersion;        ///< The current format version
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_COMPRESSED_EVENT_FILE_H
@@ -0,0 +1,126 @@
+/**
+ *  @file   LArReco/include/EventDecompressor.h
+ *
+ *  @brief  Header file for the event decompressor class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_EVENT_DECOMPRESSOR_H
+#define LAR_RECO_EVENT_DECOMPRESSOR_H 1
+
+#include "CompressedEventFile.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  EventDecompressor class, decompressing the compressed (.pndz) files in an event file list to binary event files on a background
+ *          thread, in list order, so that reconstruction of the first file can begin while later files are still being decompressed.
+ *          Each file is decompressed in full to the output directory (under TMPDIR by default), so a job needs free space there for the
+ *          uncompressed events alongside the compressed input, and writes every event to disk once more before reading it back.
+ */
+class EventDecompressor
+{
+public:
+    /**
+     *  @brief  Constructor, reading the block headers of each compressed file and starting the background thread
+     *
+     *  @param  eventFileNameList the colon-separated list of event files
+     *  @param  outputDirectory the directory in which to write the decompressed files
+     *  @param  nThreads the number of threads with which to decompress the blocks of each file
+     */
+    EventDecompressor(const std::string &eventFileNameList, const std::string &outputDirectory, const unsigned int nThreads);
+
+    /**
+     *  @brief  Destructor, stopping the background thread once the file in progress is complete
+     */
+    ~EventDecompressor();
+
+    /**
+     *  @brief  Deleted copy constructor
+     */
+    EventDecompressor(const EventDecompressor &) = delete;
+
+    /**
+     *  @brief  Deleted assignment operator
+     */
+    EventDecompressor &operator=(const EventDecompressor &) = delete;
+
+    /**
+     *  @brief  Whether an event file list contains any compressed files
+     *
+     *  @param  eventFileNameList the colon-separated list of event files
+     *
+     *  @return boolean
+     */
+    static bool HasCompressedFiles(const std::string &eventFileNameList);
+
+    /**
+     *  @brief  Get the event file list in which each compressed file is replaced by its decompressed binary file
+     *
+     *  @return the colon-separated list of event files
+     */
+    const std::string &GetEventFileNameList() const;
+
+    /**
+     *  @brief  Wait until a file in the event file list, and all files before it, are ready to be read
+     *
+     *  @param  fileIndex the index of the file in the event file list
+     *
+     *  @return whether the file is ready, false if decompression failed or was stopped
+     */
+    bool WaitForFile(const unsigned int fileIndex);
+
+    /**
+     *  @brief  Wait until all files in the event file list are ready to be read
+     *
+     *  @return whether all files are ready, false if decompression failed or was stopped
+     */
+    bool WaitForAll();
+
+    /**
+     *  @brief  Stop decompression once the file in progress is complete, releasing any waiting threads
+     */
+    void Stop();
+
+private:
+    /**
+     *  @brief  EventFile class, describing a single file in the event file list
+     */
+    class EventFile
+    {
+    public:
+        std::string                     m_inputFileName;    ///< The event file name, as given
+        std::string                     m_outputFileName;   ///< The name of the file to be read
+        CompressedEventFile::BlockList  m_blockList;        ///< The compressed blocks (empty if the file is not compressed)
+    };
+
+    typedef std::vector<EventFile> EventFileList;
+
+    /**
+     *  @brief  The background thread body, decompressing each compressed file in turn
+     */
+    void Run();
+
+    const unsigned int          m_nThreads;             ///< The number of threads with which to decompress the blocks of each file
+    EventFileList               m_eventFileList;        ///< The files in the event file list, in order
+    std::string                 m_eventFileNameList;    ///< The event file list, with compressed files replaced by decompressed files
+
+    std::mutex                  m_mutex;                ///< The mutex protecting the state below
+    std::condition_variable     m_condition;            ///< The condition variable signalling changes to the state below
+    unsigned int                m_nFilesReady;          ///< The number of files, from the start of the list, ready to be read
+    bool                        m_isFailed;             ///< Whether decompression failed
+    bool                        m_shouldStop;           ///< Whether the background thread should stop
+
+    std::thread                 m_thread;               ///< The background thread
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_EVENT_DECOMPRESSOR_H
@@ -0,0 +1,209 @@
+/**
+ *  @file   LArReco/include/EventFileHelper.h
+ *
+ *  @brief  Header file for the event file helper class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_EVENT_FILE_HELPER_H
+#define LAR_RECO_EVENT_FILE_HELPER_H 1
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  EventFileHelper class, providing utilities for navigating the containers in binary (.pndr) pandora event files, including an
+ *          index sidecar (.pndr.idx) recording the location of each event container
+ */
+class EventFileHelper
+{
+public:
+    /**
+     *  @brief  Container class, describing the location of a single container within a binary event file
+     */
+    class Container
+    {
+    public:
+        std::uint64_t       m_offset;               ///< The byte offset of the container header
+        std::uint64_t       m_size;                 ///< The size of the container, including its header, units bytes
+    };
+
+    typedef std::vector<Container> ContainerList;
+    typedef std::vector<unsigned int> EventIndexList;
+
+    /**
+     *  @brief  Whether a file is a binary pandora file, as identified by the .pndr extension used by LArEventReading
+     *
+     *  @param  fileName the file name
+     *
+     *  @return boolean
+     */
+    static bool IsBinaryFile(const std::string &fileName);
+
+    /**
+     *  @brief  Get the event containers in a binary event file, in file order, from the index sidecar if it is up to date, else by scanning
+     *
+     *  @param  fileName the file name
+     *  @param  containerList to receive the event containers
+     */
+    static void GetEventContainers(const std::string &fileName, ContainerList &containerList);
+
+    /**
+     *  @brief  Get the event containers in a binary event file, in file order, by following the container sizes recorded in each header
+     *
+     *  @param  fileName the file name
+     *  @param  containerList to receive the event containers
+     */
+    static void ScanEventContainers(const std::string &fileName, ContainerList &containerList);
+
+    /**
+     *  @brief  Get the name of the index sidecar for a binary event file
+     *
+     *  @param  fileName the event file name
+     *
+     *  @return the index file name
+     */
+    static std::string GetIndexFileName(const std::string &fileName);
+
+    /**
+     *  @brief  Read the index sidecar for a binary event file
+     *
+     *  @param  fileName the event file name
+     *  @param  containerList to receive the event containers
+     *
+     *  @return whether an index was found that matches the current size and modification time of the event file, with entries that fit
+     *          within both files
+     */
+    static bool ReadIndex(const std::string &fileName, ContainerList &containerList);
+
+    /**
+     *  @brief  Scan a binary event file and write its index sidecar, replacing any existing index
+     *
+     *  @param  fileName the event file name
+     *
+     *  @return the number of events indexed
+     */
+    static unsigned int WriteIndex(const std::string &fileName);
+
+    /**
+     *  @brief  Write a selection of events to a new binary event file, with its index, seeking directly to each selected event container.
+     *          Any containers preceding the first event (e.g. a geometry container) are also copied.
+     *
+     *  @param  fileName the input event file name
+     *  @param  eventIndexList the indices of the events to select, in the order in which they should be written
+     *  @param  outputFileName the output event file name
+     */
+    static void WriteEventSelection(const std::string &fileName, const EventIndexList &eventIndexList, const std::string &outputFileName);
+
+    /**
+     *  @brief  Continue a count of the complete event containers in a binary event file, from the end of the last event container counted,
+     *          so that a file growing during a job need not be followed from its start after each event
+     *
+     *  @param  fileName the event file name
+     *  @param  nCompleteEvents the number of complete event containers counted so far, to receive the updated number
+     *  @param  endOffset the end of the last event container counted so far (zero before any count), to receive the updated end
+     */
+    static void UpdateCompleteEvents(const std::string &fileName, unsigned int &nCompleteEvents, std::uint64_t &endOffset);
+
+    /**
+     *  @brief  Truncate a binary event file after a given number of event containers, discarding any later (possibly incomplete) containers.
+     *          Any index sidecar is invalidated by the change in file size.
+     *
+     *  @param  fileName the event file name
+     *  @param  nEvents the number of event containers to keep
+     *
+     *  @return success, false if the file holds fewer complete event containers
+     */
+    static bool TruncateEvents(const std::string &fileName, const unsigned int nEvents);
+
+    /**
+     *  @brief  Read a container header at a given position in a binary event file
+     *
+     *  @param  fd the file descriptor
+     *  @param  offset the byte offset of the container header
+     *  @param  isEventContainer to receive whether the container holds an event
+     *  @param  containerSize to receive the size of the container, units bytes
+     *
+     *  @return whether a valid header was read
+     */
+    static bool ReadContainerHeader(const int fd, const std::uint64_t offset, bool &isEventContainer, std::uint64_t &containerSize);
+
+    /**
+     *  @brief  Get the size of a container header
+     *
+     *  @return the header size, units bytes
+     */
+    static std::size_t GetContainerHeaderSize();
+
+private:
+    /**
+     *  @brief  IndexHeader class, the fixed-size header at the start of an index sidecar, followed by one container record per event
+     */
+    class IndexHeader
+    {
+    public:
+        char                m_magic[8];             ///< The magic number identifying the format
+        std::uint32_t       m_version;              ///< The format version
+        std::uint32_t       m_padding;              ///< Padding, for alignment of the fields below
+        std::uint64_t       m_fileSize;             ///< The size of the indexed event file, units bytes
+        std::int64_t        m_modificationTime;     ///< The modification time of the indexed event file, units s since the epoch
+        std::uint64_t       m_nEvents;              ///< The number of event containers
+    };
+
+    /**
+     *  @brief  Get the size and modification time of a file
+     *
+     *  @param  fileName the file name
+     *  @param  fileSize to receive the file size, units bytes
+     *  @param  modificationTime to receive the modification time, units s since the epoch
+     *
+     *  @return whether the file could be inspected
+     */
+    static bool GetFileStatus(const std::string &fileName, std::uint64_t &fileSize, std::int64_t &modificationTime);
+
+    /**
+     *  @brief  Follow the containers in a binary event file, stopping after a given number of event containers or at the first incomplete or
+     *          invalid container
+     *
+     *  @param  fileName the event file name
+     *  @param  maxEvents the maximum number of event containers to follow
+     *  @param  nCompleteEvents the number of event containers already followed (zero to start at the beginning of the file), to receive the
+     *          number of complete event containers followed
+     *  @param  endOffset the end of the last event container already followed (zero to start at the beginning of the file), to receive the
+     *          end of the last event container followed (the end of any leading non-event containers, if none)
+     *
+     *  @return whether the file could be opened
+     */
+    static bool FindEventsEnd(const std::string &fileName, const unsigned int maxEvents, unsigned int &nCompleteEvents, std::uint64_t &endOffset);
+
+    /**
+     *  @brief  Write an index sidecar describing a given list of event containers
+     *
+     *  @param  fileName the event file name
+     *  @param  containerList the event containers
+     */
+    static void WriteIndex(const std::string &fileName, const ContainerList &containerList);
+
+    /**
+     *  @brief  Copy a byte range from one file to the end of another
+     *
+     *  @param  inputFd the input file descriptor
+     *  @param  offset the start of the range in the input file
+     *  @param  size the size of the range
+     *  @param  outputFd the output file descriptor
+     *
+     *  @return success
+     */
+    static bool CopyRange(const int inputFd, const std::uint64_t offset, const std::uint64_t size, const int outputFd);
+
+    static const char           m_indexMagicNumber[8];  ///< The magic number identifying the index format
+    static const std::uint32_t  m_indexFormatVersion;   ///< The current index format version
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_EVENT_FILE_HELPER_H
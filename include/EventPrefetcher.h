@@ -0,0 +1,113 @@
+/**
+ *  @file   LArReco/include/EventPrefetcher.h
+ *
+ *  @brief  Header file for the event prefetcher class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_EVENT_PREFETCHER_H
+#define LAR_RECO_EVENT_PREFETCHER_H 1
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace lar_reco
+{
+
+class EventDecompressor;
+
+/**
+ *  @brief  EventPrefetcher class, reading upcoming events from binary event files on a background thread, so that the reads issued by
+ *          LArEventReading are served from the page cache rather than waiting on (possibly remote) storage. Files still being decompressed
+ *          are awaited before being read.
+ */
+class EventPrefetcher
+{
+public:
+    /**
+     *  @brief  Constructor, starting the background thread
+     *
+     *  @param  eventFileNameList the colon-separated list of event files, in processing order
+     *  @param  nEventsToSkip the number of events to skip in the first file
+     *  @param  lookaheadDepth the number of events to hold ready ahead of the event being reconstructed
+     *  @param  pEventDecompressor the address of the decompressor producing the event files, if any
+     */
+    EventPrefetcher(const std::string &eventFileNameList, const int nEventsToSkip, const unsigned int lookaheadDepth,
+        EventDecompressor *const pEventDecompressor);
+
+    /**
+     *  @brief  Destructor, stopping the background thread, and any decompressor on which it waits
+     */
+    ~EventPrefetcher();
+
+    /**
+     *  @brief  Deleted copy constructor
+     */
+    EventPrefetcher(const EventPrefetcher &) = delete;
+
+    /**
+     *  @brief  Deleted assignment operator
+     */
+    EventPrefetcher &operator=(const EventPrefetcher &) = delete;
+
+    /**
+     *  @brief  Wait until the next event has been prefetched, then allow the lookahead window to advance past it
+     *
+     *  @return the time spent waiting, units s
+     */
+    double WaitForNextEvent();
+
+    /**
+     *  @brief  Get the total number of bytes prefetched
+     *
+     *  @return the number of bytes
+     */
+    std::uint64_t GetBytesPrefetched() const;
+
+private:
+    /**
+     *  @brief  The background thread body, reading each event container in turn while the lookahead window allows
+     */
+    void Run();
+
+    /**
+     *  @brief  Prefetch the events in a single binary event file, while the lookahead window allows
+     *
+     *  @param  eventFileName the event file name
+     *  @param  nEventsToSkip the number of events to skip
+     *
+     *  @return whether to continue with the next file, false if the prefetcher has been stopped
+     */
+    bool PrefetchFile(const std::string &eventFileName, const unsigned int nEventsToSkip);
+
+    /**
+     *  @brief  Read a byte range of a file, so that it is resident in the page cache
+     *
+     *  @param  fd the file descriptor
+     *  @param  offset the start of the range
+     *  @param  size the size of the range
+     */
+    void ReadRange(const int fd, const std::uint64_t offset, const std::uint64_t size) const;
+
+    const std::string           m_eventFileNameList;    ///< The colon-separated list of event files
+    const int                   m_nEventsToSkip;        ///< The number of events to skip in the first file
+    const unsigned int          m_lookaheadDepth;       ///< The number of events to hold ready ahead of the event being reconstructed
+    EventDecompressor *const    m_pEventDecompressor;   ///< The address of the decompressor producing the event files, if any
+
+    mutable std::mutex          m_mutex;                ///< The mutex protecting the counters below
+    std::condition_variable     m_condition;            ///< The condition variable signalling changes to the counters
+    unsigned int                m_nEventsPrefetched;    ///< The number of events prefetched
+    unsigned int                m_nEventsConsumed;      ///< The number of events handed to reconstruction
+    std::uint64_t               m_bytesPrefetched;      ///< The number of bytes prefetched
+    bool                        m_isFinished;           ///< Whether all events have been prefetched
+    bool                        m_shouldStop;           ///< Whether the background thread should stop
+
+    std::thread                 m_thread;               ///< The background thread
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_EVENT_PREFETCHER_H
@@ -0,0 +1,154 @@
+/**
+ *  @file   LArReco/include/EventStatistics.h
+ *
+ *  @brief  Header file for the event statistics class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_EVENT_STATISTICS_H
+#define LAR_RECO_EVENT_STATISTICS_H 1
+
+#include "MemoryMonitor.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  EventStatistics class, collecting the latency and memory usage of each processed event
+ */
+class EventStatistics
+{
+public:
+    /**
+     *  @brief  EventRecord class, describing the resources used to process a single event
+     */
+    class EventRecord
+    {
+    public:
+        /**
+         *  @brief  Default constructor
+         */
+        EventRecord();
+
+        /**
+         *  @brief  Get the total wall time for the event, including the reset
+         *
+         *  @return the total wall time, units s
+         */
+        double GetTotalTime() const;
+
+        std::string                     m_eventFileName;              ///< The file, as given, from which the event was read
+        int                             m_eventNumber;                ///< The event number within the file
+        unsigned int                    m_threadIndex;                ///< The index of the event-parallel thread that processed the event
+        double                          m_inputStallTime;             ///< The wall time spent waiting for the event to be prefetched or decompressed, units s
+        double                          m_processTime;                ///< The wall time for PandoraApi::ProcessEvent, units s
+        double                          m_resetTime;                  ///< The wall time for PandoraApi::Reset, units s
+        long                            m_peakResidentMemory;         ///< The resident memory high-water mark while processing the event, units kB
+        long                            m_nAllocations;               ///< The number of heap allocations made while processing and resetting the event
+        long                            m_nFilterInputHits;           ///< The number of hits examined by the hit filter (or -1 if no hit filter ran)
+        long                            m_nFilterRemovedHits;         ///< The number of hits removed by the hit filter (or -1 if no hit filter ran)
+        std::string                     m_skipReason;                 ///< Why the event was abandoned, MemoryBudget, TimeLimit or NoHitsInRegion (empty if not)
+        MemoryMonitor::StagePeakMap     m_stagePeakResidentMemory;    ///< The peak resident memory for each reconstruction stage, units kB
+    };
+
+    typedef std::vector<EventRecord> EventRecordList;
+
+    /**
+     *  @brief  Default constructor
+     */
+    EventStatistics();
+
+    /**
+     *  @brief  Prepare to measure the resources used by the next event, resetting the resident memory high-water mark
+     */
+    void StartEvent() const;
+
+    /**
+     *  @brief  Add the record for a processed event. Each thread must add its events in input order.
+     *
+     *  @param  eventRecord the event record
+     */
+    void AddEvent(const EventRecord &eventRecord);
+
+    /**
+     *  @brief  Get the number of events recorded
+     *
+     *  @return the number of events
+     */
+    unsigned int GetNumberOfEvents() const;
+
+    /**
+     *  @brief  Print the latency percentiles, throughput, peak memory usage, allocations, skipped events and slowest events
+     *
+     *  @param  wallTime the total wall time for event processing, units s
+     */
+    void DisplaySummary(const double wallTime) const;
+
+    /**
+     *  @brief  Write the per-event records to a csv file, in input order
+     *
+     *  @param  fileName the output file name
+     */
+    void WriteEventLog(const std::string &fileName) const;
+
+    /**
+     *  @brief  Get the resident memory high-water mark for this process, as reported by /proc/self/status
+     *
+     *  @return the resident memory high-water mark, units kB (or -1 if unavailable)
+     */
+    static long GetPeakResidentMemory();
+
+    /**
+     *  @brief  Get a latency percentile, using the nearest-rank method
+     *
+     *  @param  sortedTimes the event wall times, in ascending order
+     *  @param  percentile the percentile
+     *
+     *  @return the latency percentile, units s
+     */
+    static double GetPercentile(const std::vector<double> &sortedTimes, const double percentile);
+
+private:
+    /**
+     *  @brief  Get the event records, sorted into input order. Threads receive contiguous blocks of the input in thread order.
+     *
+     *  @return the sorted event records
+     */
+    EventRecordList GetSortedEventRecords() const;
+
+    mutable std::mutex      m_mutex;                ///< The mutex protecting the event records from concurrent event-parallel threads
+    EventRecordList         m_eventRecordList;      ///< The event records
+    bool                    m_canResetPeakMemory;   ///< Whether the resident memory high-water mark can be reset between events
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline EventStatistics::EventRecord::EventRecord() :
+    m_eventFileName(""),
+    m_eventNumber(0),
+    m_threadIndex(0),
+    m_inputStallTime(0.),
+    m_processTime(0.),
+    m_resetTime(0.),
+    m_peakResidentMemory(-1),
+    m_nAllocations(0),
+    m_nFilterInputHits(-1),
+    m_nFilterRemovedHits(-1),
+    m_skipReason("")
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline double EventStatistics::EventRecord::GetTotalTime() const
+{
+    return m_processTime + m_resetTime;
+}
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_EVENT_STATISTICS_H
@@ -0,0 +1,83 @@
+/**
+ *  @file   LArReco/include/EventWatchdog.h
+ *
+ *  @brief  Header file for the event watchdog class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_EVENT_WATCHDOG_H
+#define LAR_RECO_EVENT_WATCHDOG_H 1
+
+#include <string>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  EventWatchdog class, checking the wall time of the event on each thread against the configured limit at the boundaries of the
+ *          wrapped algorithms. The limit is cooperative: running algorithms are never interrupted, so an event is abandoned at the first
+ *          boundary after its limit, however long that takes. As a backstop, a hard limit may also be set, which a background thread
+ *          enforces by ending the whole job, as an algorithm (or tool) that never returns cannot be abandoned safely.
+ */
+class EventWatchdog
+{
+public:
+    /**
+     *  @brief  Set the wall time limit for each event. Must be called before any events are processed.
+     *
+     *  @param  timeLimit the time limit, units s (no limit if zero)
+     */
+    static void SetTimeLimit(const double timeLimit);
+
+    /**
+     *  @brief  Set the hard wall time limit for each event, starting the backstop thread if non-zero. Must be called before any events are
+     *          processed.
+     *
+     *  @param  hardTimeLimit the hard time limit, units s (no limit if zero)
+     */
+    static void SetHardTimeLimit(const double hardTimeLimit);
+
+    /**
+     *  @brief  Whether the watchdog is enabled
+     *
+     *  @return boolean
+     */
+    static bool IsEnabled();
+
+    /**
+     *  @brief  Begin timing an event on the calling thread
+     */
+    static void BeginEvent();
+
+    /**
+     *  @brief  End timing the event on the calling thread, so that the backstop thread no longer considers it
+     */
+    static void EndEvent();
+
+    /**
+     *  @brief  Check the wall time of the event on the calling thread against the limit
+     *
+     *  @param  algorithmType the type of the algorithm just completed, to identify where the limit was exceeded
+     *
+     *  @return whether the event remains within the limit
+     */
+    static bool CheckTime(const std::string &algorithmType);
+
+    /**
+     *  @brief  Whether the event on the calling thread has exceeded the limit
+     *
+     *  @return boolean
+     */
+    static bool IsEventOverTime();
+
+    /**
+     *  @brief  Describe the time limit overrun for the event on the calling thread
+     *
+     *  @return the description
+     */
+    static std::string GetOverTimeDescription();
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_EVENT_WATCHDOG_H
@@ -0,0 +1,127 @@
+/**
+ *  @file   LArReco/include/HitFilterAlgorithm.h
+ *
+ *  @brief  Header file for the hit filter algorithm class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_HIT_FILTER_ALGORITHM_H
+#define LAR_RECO_HIT_FILTER_ALGORITHM_H 1
+
+#include "Pandora/Algorithm.h"
+
+#include <unordered_set>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  HitFilterAlgorithm class, to be run before LArPreProcessing, replacing the current calo hit list with the hits that lie within
+ *          the configured regions of interest: a set of TPC volumes, a drift time window, a user-defined box and/or the bounds of each hit's
+ *          TPC volume, as described by the geometry. Hits in the detector gaps (dead regions) described by the geometry may also be removed.
+ *          The hits examined and removed are counted for each event on the calling thread. An event without any hits in the regions of
+ *          interest is abandoned, as Pandora cannot save an empty list to replace the current list.
+ */
+class HitFilterAlgorithm : public pandora::Algorithm
+{
+public:
+    /**
+     *  @brief  Factory class for instantiating algorithm
+     */
+    class Factory : public pandora::AlgorithmFactory
+    {
+    public:
+        pandora::Algorithm *CreateAlgorithm() const;
+    };
+
+    /**
+     *  @brief  Default constructor
+     */
+    HitFilterAlgorithm();
+
+    /**
+     *  @brief  Begin counting the hits filtered for an event on the calling thread
+     */
+    static void BeginEvent();
+
+    /**
+     *  @brief  Get the number of hits examined by any hit filter for the event on the calling thread
+     *
+     *  @return the number of hits (or -1 if no hit filter has run)
+     */
+    static long GetEventInputHits();
+
+    /**
+     *  @brief  Get the number of hits removed by any hit filter for the event on the calling thread
+     *
+     *  @return the number of hits (or -1 if no hit filter has run)
+     */
+    static long GetEventRemovedHits();
+
+    /**
+     *  @brief  Whether a hit filter found no hits within the regions of interest for the event on the calling thread, abandoning the event
+     *
+     *  @return boolean
+     */
+    static bool IsEventWithoutHits();
+
+private:
+    pandora::StatusCode Run();
+    pandora::StatusCode ReadSettings(const pandora::TiXmlHandle xmlHandle);
+
+    /**
+     *  @brief  Whether a calo hit lies within the regions of interest
+     *
+     *  @param  pCaloHit the address of the calo hit
+     *
+     *  @return boolean
+     */
+    bool IsInRegionOfInterest(const pandora::CaloHit *const pCaloHit) const;
+
+    /**
+     *  @brief  Whether a calo hit lies within the user-defined box, comparing only the coordinates that its view measures
+     *
+     *  @param  pCaloHit the address of the calo hit
+     *
+     *  @return boolean
+     */
+    bool IsInBox(const pandora::CaloHit *const pCaloHit) const;
+
+    /**
+     *  @brief  Whether a calo hit lies within any of the detector gaps described by the geometry
+     *
+     *  @param  pCaloHit the address of the calo hit
+     *
+     *  @return boolean
+     */
+    bool IsInDetectorGap(const pandora::CaloHit *const pCaloHit) const;
+
+    typedef std::unordered_set<unsigned int> VolumeIdSet;
+
+    std::string     m_outputCaloHitListName;    ///< The name of the filtered calo hit list, to become the current list
+    VolumeIdSet     m_volumeIds;                ///< The TPC volumes from which to keep hits (all volumes if empty)
+    float           m_minTime;                  ///< The start of the drift time window
+    float           m_maxTime;                  ///< The end of the drift time window
+    float           m_minX;                     ///< The lower x bound of the user-defined box
+    float           m_maxX;                     ///< The upper x bound of the user-defined box
+    float           m_minY;                     ///< The lower y bound of the user-defined box, applied to 3D hits
+    float           m_maxY;                     ///< The upper y bound of the user-defined box, applied to 3D hits
+    float           m_minZ;                     ///< The lower z bound of the user-defined box, applied to W and 3D hits
+    float           m_maxZ;                     ///< The upper z bound of the user-defined box, applied to W and 3D hits
+    bool            m_shouldUseVolumeBounds;    ///< Whether to remove hits outside the bounds of their TPC volume, as described by the geometry
+    float           m_volumeBoundsTolerance;    ///< The distance by which hits may lie outside the bounds of their TPC volume
+    bool            m_shouldRemoveGapHits;      ///< Whether to remove hits within the detector gaps described by the geometry
+    float           m_gapTolerance;             ///< The distance around each detector gap within which hits are also removed
+    bool            m_shouldPrintCounts;        ///< Whether to print the hits examined and removed for each event
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline pandora::Algorithm *HitFilterAlgorithm::Factory::CreateAlgorithm() const
+{
+    return new HitFilterAlgorithm();
+}
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_HIT_FILTER_ALGORITHM_H
@@ -0,0 +1,77 @@
+/**
+ *  @file   LArReco/include/JobCheckpoint.h
+ *
+ *  @brief  Header file for the job checkpoint class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_JOB_CHECKPOINT_H
+#define LAR_RECO_JOB_CHECKPOINT_H 1
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  JobCheckpoint class, recording the progress of a job through its events, together with the number of complete events found in each
+ *          binary event file that it writes, so that an interrupted job can be resumed without duplicating or losing output events
+ */
+class JobCheckpoint
+{
+public:
+    /**
+     *  @brief  WrittenFile class, describing a binary event file written by the job
+     */
+    class WrittenFile
+    {
+    public:
+        std::string     m_fileName;             ///< The event file name
+        unsigned int    m_nInitialEvents;       ///< The number of events in the file before the job started
+        unsigned int    m_nEvents;              ///< The number of complete events in the file at this checkpoint
+        std::uint64_t   m_endOffset;            ///< The end of the last complete event container in the file at this checkpoint
+    };
+
+    typedef std::vector<WrittenFile> WrittenFileList;
+
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  fileName the checkpoint file name
+     */
+    JobCheckpoint(const std::string &fileName);
+
+    /**
+     *  @brief  Read the checkpoint file
+     *
+     *  @return whether a valid checkpoint was read, false if the file does not exist; throws if the file is not a valid checkpoint
+     */
+    bool Read();
+
+    /**
+     *  @brief  Write the checkpoint file, replacing the previous checkpoint atomically
+     */
+    void Write() const;
+
+    /**
+     *  @brief  Record the completion of an event, counting the complete events now in each written file, then write the checkpoint file
+     */
+    void AddCompletedEvent();
+
+    const std::string   m_fileName;             ///< The checkpoint file name
+    std::string         m_eventFileNameList;    ///< The colon-separated list of event files read by the job
+    std::string         m_eventList;            ///< The event list for the job (empty if none)
+    int                 m_nEventsToSkip;        ///< The number of events skipped at the start of the job
+    int                 m_nEventsToProcess;     ///< The number of events to be processed by the job (all if negative)
+    unsigned int        m_nEventsCompleted;     ///< The number of events completed, including any skipped as over their limits
+    WrittenFileList     m_writtenFileList;      ///< The binary event files written by the job
+
+private:
+    static const std::string    m_formatName;   ///< The name and version identifying the checkpoint format
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_JOB_CHECKPOINT_H
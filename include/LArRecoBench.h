@@ -0,0 +1,174 @@
+/**
+ *  @file   LArReco/include/LArRecoBench.h
+ *
+ *  @brief  Header file for the LArReco benchmark application.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_BENCH_H
+#define LAR_RECO_BENCH_H 1
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lar_reco_bench
+{
+
+/**
+ *  @brief  BenchParameters class
+ */
+class BenchParameters
+{
+public:
+    /**
+     *  @brief Default constructor
+     */
+    BenchParameters();
+
+    std::string         m_manifestFileName;         ///< The benchmark manifest, listing the configurations, samples and reco options (mandatory)
+    std::string         m_sampleDirectory;          ///< The directory containing the versioned event samples (mandatory)
+    std::string         m_executable;               ///< The PandoraInterface executable to benchmark
+    std::string         m_baselineFileName;         ///< The stored baseline against which to compare results (no comparison if empty)
+    std::string         m_outputFileName;           ///< The file to receive the results, in baseline format (no output if empty)
+    std::string         m_configurationName;        ///< The single configuration to run (all configurations if empty)
+    double              m_throughputTolerance;      ///< The tolerated fractional loss of throughput, relative to the baseline
+    double              m_latencyTolerance;         ///< The tolerated fractional increase in each latency percentile, relative to the baseline
+    double              m_memoryTolerance;          ///< The tolerated fractional increase in peak memory, relative to the baseline
+};
+
+/**
+ *  @brief  BenchCase class, describing a single detector configuration and reco option to be benchmarked
+ */
+class BenchCase
+{
+public:
+    std::string         m_configurationName;        ///< The configuration name
+    std::string         m_settingsFile;             ///< The master settings file
+    std::string         m_geometryFile;             ///< The geometry file
+    std::string         m_eventFile;                ///< The event sample file
+    std::string         m_recoOption;               ///< The reco option
+    int                 m_nEvents;                  ///< The number of events to process
+};
+
+typedef std::vector<BenchCase> BenchCaseList;
+
+/**
+ *  @brief  BenchResult class, describing the performance measured for a single benchmark case
+ */
+class BenchResult
+{
+public:
+    /**
+     *  @brief Default constructor
+     */
+    BenchResult();
+
+    int                 m_nEvents;                  ///< The number of events processed
+    double              m_throughput;               ///< The throughput over the wall time of the whole run, including initialisation, units events/s
+    double              m_latencyP50;               ///< The median per-event latency, units s
+    double              m_latencyP95;               ///< The 95th percentile per-event latency, units s
+    double              m_latencyP99;               ///< The 99th percentile per-event latency, units s
+    long                m_peakMemory;               ///< The peak resident memory of the process, units kB
+};
+
+typedef std::pair<std::string, std::string> BenchKey;       ///< The configuration name and reco option
+typedef std::map<BenchKey, BenchResult> BenchResultMap;
+
+/**
+ *  @brief  Parse the command line arguments, setting the benchmark parameters
+ *
+ *  @param  argc argument count
+ *  @param  argv argument vector
+ *  @param  parameters to receive the benchmark parameters
+ *
+ *  @return success
+ */
+bool ParseCommandLine(int argc, char *argv[], BenchParameters &parameters);
+
+/**
+ *  @brief  Print the list of configurable options
+ *
+ *  @return false, to force abort
+ */
+bool PrintOptions();
+
+/**
+ *  @brief  Read the benchmark manifest, with file names resolved relative to the manifest and sample directories
+ *
+ *  @param  parameters the benchmark parameters
+ *  @param  sampleVersion to receive the event sample version
+ *  @param  benchCaseList to receive the benchmark cases
+ */
+void ReadManifest(const BenchParameters &parameters, std::string &sampleVersion, BenchCaseList &benchCaseList);
+
+/**
+ *  @brief  Run a single benchmark case in a PandoraInterface subprocess
+ *
+ *  @param  parameters the benchmark parameters
+ *  @param  benchCase the benchmark case
+ *  @param  workingDirectory the directory to receive the subprocess logs
+ *  @param  benchResult to receive the benchmark result
+ */
+void RunBenchCase(const BenchParameters &parameters, const BenchCase &benchCase, const std::string &workingDirectory, BenchResult &benchResult);
+
+/**
+ *  @brief  Read a file of benchmark results
+ *
+ *  @param  fileName the file name
+ *  @param  sampleVersion to receive the event sample version
+ *  @param  benchResultMap to receive the benchmark results
+ */
+void ReadResults(const std::string &fileName, std::string &sampleVersion, BenchResultMap &benchResultMap);
+
+/**
+ *  @brief  Write a file of benchmark results, suitable for use as a baseline
+ *
+ *  @param  fileName the file name
+ *  @param  sampleVersion the event sample version
+ *  @param  benchResultMap the benchmark results
+ */
+void WriteResults(const std::string &fileName, const std::string &sampleVersion, const BenchResultMap &benchResultMap);
+
+/**
+ *  @brief  Print the benchmark results, flagging any that fall outside the configured tolerances of the baseline
+ *
+ *  @param  parameters the benchmark parameters
+ *  @param  benchResultMap the benchmark results
+ *  @param  baselineResultMap the baseline results (empty if there is no baseline)
+ *
+ *  @return whether all results lie within tolerance of the baseline
+ */
+bool CompareResults(const BenchParameters &parameters, const BenchResultMap &benchResultMap, const BenchResultMap &baselineResultMap);
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline BenchParameters::BenchParameters() :
+    m_manifestFileName(""),
+    m_sampleDirectory(""),
+    m_executable(""),
+    m_baselineFileName(""),
+    m_outputFileName(""),
+    m_configurationName(""),
+    m_throughputTolerance(0.1),
+    m_latencyTolerance(0.1),
+    m_memoryTolerance(0.1)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline BenchResult::BenchResult() :
+    m_nEvents(0),
+    m_throughput(0.),
+    m_latencyP50(0.),
+    m_latencyP95(0.),
+    m_latencyP99(0.),
+    m_peakMemory(0)
+{
+}
+
+} // namespace lar_reco_bench
+
+#endif // #ifndef LAR_RECO_BENCH_H
@@ -0,0 +1,36 @@
+/**
+ *  @file   LArReco/include/LArRecoContent.h
+ *
+ *  @brief  Header file for the LArReco content class, registering the algorithms provided by this package.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_CONTENT_H
+#define LAR_RECO_CONTENT_H 1
+
+#include "Pandora/StatusCodes.h"
+
+namespace pandora {class Pandora;}
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  LArRecoContent class
+ */
+class LArRecoContent
+{
+public:
+    /**
+     *  @brief  Register all the LArReco algorithms with pandora
+     *
+     *  @param  pandora the pandora instance with which to register content
+     *
+     *  @return the status code
+     */
+    static pandora::StatusCode RegisterAlgorithms(const pandora::Pandora &pandora);
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_CONTENT_H
@@ -0,0 +1,136 @@
+/**
+ *  @file   LArReco/include/MemoryMonitor.h
+ *
+ *  @brief  Header file for the memory monitor class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_MEMORY_MONITOR_H
+#define LAR_RECO_MEMORY_MONITOR_H 1
+
+#include <map>
+#include <string>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  MemoryMonitor class, sampling the resident memory at the boundaries of the wrapped algorithms, recording the peak for each
+ *          reconstruction stage and flagging any event whose resident memory growth exceeds the configured budget. Resident memory is
+ *          shared by all event-parallel threads, so monitoring requires single-threaded event processing.
+ *
+ *          The stages are the top-level algorithms, e.g. LArPreProcessing and LArMaster, and the LArMaster worker stages: AllHitsCosmicReco,
+ *          Slicing and SliceReco. LArMaster runs the same CR settings for all-hits cosmic-ray reconstruction, before slicing, and for the
+ *          cosmic-ray hypothesis of each slice, alongside the Nu settings; these are told apart by whether a slicing or Nu stage has begun.
+ *          With slicing disabled, a lone slice holds all of the hits, so cosmic-ray reconstruction before any Nu stage is reported as all-hits.
+ */
+class MemoryMonitor
+{
+public:
+    typedef std::map<std::string, long> StagePeakMap;
+
+    /**
+     *  @brief  StageScope class, marking the calling thread as within a reconstruction stage for its lifetime
+     */
+    class StageScope
+    {
+    public:
+        /**
+         *  @brief  Constructor, entering a stage (no stage if the name is empty)
+         *
+         *  @param  stageName the stage name
+         */
+        StageScope(const std::string &stageName);
+
+        /**
+         *  @brief  Destructor, leaving the stage
+         */
+        ~StageScope();
+
+        /**
+         *  @brief  Deleted copy constructor
+         */
+        StageScope(const StageScope &) = delete;
+
+        /**
+         *  @brief  Deleted assignment operator
+         */
+        StageScope &operator=(const StageScope &) = delete;
+
+    private:
+        /**
+         *  @brief  Get the reported name of a stage, resolving the LArMaster worker stages named after their settings files (CR, Slicing, Nu)
+         *
+         *  @param  stageName the stage name
+         *
+         *  @return the reported stage name
+         */
+        static std::string GetReportedStageName(const std::string &stageName);
+
+        bool    m_isStage;      ///< Whether a stage was entered
+    };
+
+    /**
+     *  @brief  Set the budget for the resident memory growth during each event. Must be called before any events are processed.
+     *
+     *  @param  budget the budget, units kB (no monitoring if zero)
+     */
+    static void SetBudget(const long budget);
+
+    /**
+     *  @brief  Whether memory monitoring is enabled
+     *
+     *  @return boolean
+     */
+    static bool IsEnabled();
+
+    /**
+     *  @brief  Begin monitoring an event on the calling thread, taking the current resident memory as the baseline
+     */
+    static void BeginEvent();
+
+    /**
+     *  @brief  End monitoring the event on the calling thread, so that later samples are not attributed to it. The stage peaks and any
+     *          budget overrun remain available until the next event begins.
+     */
+    static void EndEvent();
+
+    /**
+     *  @brief  Sample the resident memory, updating the stage peaks and checking the budget for the event on the calling thread
+     *
+     *  @return whether the event remains within budget
+     */
+    static bool CheckMemory();
+
+    /**
+     *  @brief  Whether the event on the calling thread has exceeded the budget
+     *
+     *  @return boolean
+     */
+    static bool IsEventOverBudget();
+
+    /**
+     *  @brief  Describe the budget overrun for the event on the calling thread
+     *
+     *  @return the description
+     */
+    static std::string GetOverBudgetDescription();
+
+    /**
+     *  @brief  Get the peak resident memory for each stage of the event on the calling thread
+     *
+     *  @return the stage peak map, units kB
+     */
+    static const StagePeakMap &GetStagePeakMemory();
+
+    /**
+     *  @brief  Get the current resident memory for this process, as reported by /proc/self/statm. No heap allocations are made.
+     *
+     *  @return the resident memory, units kB (or -1 if unavailable)
+     */
+    static long GetResidentMemory();
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_MEMORY_MONITOR_H
@@ -10,7 +10,12 @@
 
 #include "Pandora/PandoraInputTypes.h"
 
+#include <exception>
+#include <memory>
+#include <vector>
+
 namespace pandora {class Pandora;}
+namespace lar_reco {class BinaryGeometry; class EventDecompressor; class EventPrefetcher; class EventStatistics; class JobCheckpoint; class PfoColumnWriter;}
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -30,11 +35,28 @@ public:
 
     std::string         m_settingsFile;                 ///< The path to the pandora settings file (mandatory parameter)
     std::string         m_eventFileNameList;            ///< Colon-separated list of file names to be processed
+    std::string         m_inputFileNameList;            ///< The file names as given, identifying events in reports (the above may name copies)
     std::string         m_geometryFileName;             ///< Name of the file containing geometry information
+    std::string         m_daemonSocketName;             ///< The unix socket on which to serve jobs in daemon mode (single job if empty)
+    std::string         m_eventLogFileName;             ///< Name of the output per-event statistics log, csv (no log if empty)
+    std::string         m_profilingFileName;            ///< Name of the output algorithm profiling report, json or csv (profiling disabled if empty)
+    std::string         m_checkpointFileName;           ///< Name of the checkpoint file, updated after each completed event (no checkpoint if empty)
+    std::string         m_pfoFileName;                  ///< Name of the output columnar pfo file, written at the end of each job (no output if empty)
+    std::string         m_eventList;                    ///< Comma-separated list of events or event ranges to process, e.g. "3,10-12" (all if empty)
+    pandora::IntVector  m_eventNumberList;              ///< The original event numbers of the events in a selected event file (none if no selection)
 
     int                 m_nEventsToProcess;             ///< The number of events to process (default all events in file)
+    int                 m_nThreads;                     ///< The number of event-parallel threads, each with its own primary pandora instance
+    int                 m_prefetchDepth;                ///< The number of binary events to read ahead of reconstruction (no prefetching if zero)
+    int                 m_memoryBudget;                 ///< The resident memory growth allowed for each event before it is skipped, units MB (no limit if zero)
+    double              m_eventTimeLimit;               ///< The wall time allowed for each event before it is skipped, units s (no limit if zero)
+    double              m_eventHardTimeLimit;           ///< The wall time allowed for each event before the job is ended, units s (twice the
+                                                        ///< above if negative, no limit if zero)
     bool                m_shouldDisplayEventNumber;     ///< Whether event numbers should be displayed (default false)
+    bool                m_shouldProfileEvents;          ///< Whether the profiling report should include a breakdown for every event
+    bool                m_shouldResume;                 ///< Whether to resume the job recorded in the checkpoint file, if it exists
 
+    bool                m_shouldUseAdaptiveSteering;    ///< Whether each LArMaster keeps the steering in its settings, e.g. as a LArRecoAdaptiveMaster path
     bool                m_shouldRunAllHitsCosmicReco;   ///< Whether to run all hits cosmic-ray reconstruction
     bool                m_shouldRunStitching;           ///< Whether to stitch cosmic-ray muons crossing between volumes
     bool                m_shouldRunCosmicHitRemoval;    ///< Whether to remove hits from tagged cosmic-rays
@@ -47,21 +69,317 @@ public:
     pandora::InputInt   m_nEventsToSkip;                ///< The number of events to skip
 };
 
+typedef std::vector<Parameters> ParametersList;
+typedef std::vector<const pandora::Pandora *> PrimaryPandoraList;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  ThreadSummary class, describing the events processed by a single event-parallel thread
+ */
+class ThreadSummary
+{
+public:
+    /**
+     *  @brief Default constructor
+     */
+    ThreadSummary();
+
+    int                 m_nEventsProcessed;             ///< The number of events processed by the thread
+    double              m_wallTime;                     ///< The wall time spent processing events, units s
+    std::exception_ptr  m_exception;                    ///< Any exception raised by the thread, to be rethrown in the main thread
+};
+
+typedef std::vector<ThreadSummary> ThreadSummaryList;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  EventScope class, beginning the per-event memory, time and hit filter monitoring on the calling thread when constructed and
+ *          ending it when destroyed, so that it ends on every exit path from PandoraApi::ProcessEvent. These include the
+ *          StopProcessingException thrown by LArEventReading at the end of the input, after which the watchdog backstop must not
+ *          consider the thread to be in an event.
+ */
+class EventScope
+{
+public:
+    /**
+     *  @brief  Constructor, beginning the monitoring
+     */
+    EventScope();
+
+    /**
+     *  @brief  Destructor, ending the monitoring. The results for the event remain available until the next event begins.
+     */
+    ~EventScope();
+
+    /**
+     *  @brief  Deleted copy constructor
+     */
+    EventScope(const EventScope &) = delete;
+
+    /**
+     *  @brief  Deleted assignment operator
+     */
+    EventScope &operator=(const EventScope &) = delete;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  EventFileLocator class, identifying the file, as given, from which an event was read and the number of the event within it
+ */
+class EventFileLocator
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  parameters the parameters describing the files to be read
+     */
+    EventFileLocator(const Parameters &parameters);
+
+    /**
+     *  @brief  Locate an event. Files are counted as the events reach them, so that a file still being decompressed is not opened early.
+     *
+     *  @param  eventNumber the event number across the files to be read, including any events skipped in the first file
+     *  @param  eventFileName to receive the file from which the event was read (the remaining files, if a file cannot be counted)
+     *  @param  fileEventNumber to receive the number of the event within that file
+     */
+    void Locate(const int eventNumber, std::string &eventFileName, int &fileEventNumber);
+
+private:
+    pandora::StringVector   m_eventFileNames;       ///< The files to be read
+    pandora::StringVector   m_inputFileNames;       ///< The files as given, in step with those to be read
+    pandora::IntVector      m_nFileEvents;          ///< The number of events in each of the files counted so far (-1 if not countable)
+};
+
+/**
+ *  @brief  Prepare for algorithm profiling, memory monitoring and/or the event watchdog, writing a copy of the settings in which every algorithm is wrapped by a
+ *          profiling algorithm
+ *
+ *  @param  parameters the application parameters, to receive the name of the rewritten settings file
+ *  @param  profilingDirectory to receive the name of the temporary directory holding the rewritten settings files
+ */
+void PrepareProfiling(Parameters &parameters, std::string &profilingDirectory);
+
+/**
+ *  @brief  Whether every algorithm is to be wrapped by a profiling algorithm, as required for profiling, a memory budget or an event time
+ *          limit, in which case the retyped LArRecoProfilingMaster must receive the same steering as LArMaster
+ *
+ *  @param  parameters the application parameters
+ *
+ *  @return boolean
+ */
+bool ShouldWrapAlgorithms(const Parameters &parameters);
+
+/**
+ *  @brief  Run a single job: create the pandora instances, process the requested events, report the event statistics, then delete the
+ *          instances
+ *
+ *  @param  parameters the application parameters
+ *  @param  pBinaryGeometry the address of the memory-mapped binary geometry, if any
+ *  @param  eventStatistics to receive the statistics for each processed event
+ *
+ *  @return success
+ */
+bool RunJob(const Parameters &parameters, const BinaryGeometry *const pBinaryGeometry, EventStatistics &eventStatistics);
+
+/**
+ *  @brief  Serve jobs received over a unix socket until a shutdown request arrives, keeping the process, libraries and geometry mapping
+ *          warm between jobs. Instances are created afresh for each job, because the event files, skip and steering are external
+ *          parameters that LArEventReading and LArMaster only read during initialisation. The event log and profiling report are written,
+ *          and the profiler cleared, at the end of each job.
+ *
+ *  @param  parameters the application parameters, providing the defaults for each job
+ *  @param  pBinaryGeometry the address of the memory-mapped binary geometry, if any
+ */
+void RunDaemon(const Parameters &parameters, const BinaryGeometry *const pBinaryGeometry);
+
+/**
+ *  @brief  Read a daemon job request, up to the first newline or the end of the stream. Gives up if the request exceeds the maximum size or
+ *          the client stalls for longer than the receive timeout set on the connection.
+ *
+ *  @param  connectionFd the file descriptor of the client connection
+ *  @param  request to receive the job request
+ *
+ *  @return whether a complete request was read
+ */
+bool ReadJobRequest(const int connectionFd, std::string &request);
+
+/**
+ *  @brief  Parse a daemon job request, a single line holding -r, -e, -n, -s, -L, -l, -o, -p and -N options as for the command line, and -P
+ *          if the daemon was started with profiling. Without -P, a profiling daemon writes each job's report to its own profiling file.
+ *
+ *  @param  request the job request
+ *  @param  parameters to receive the job parameters
+ *
+ *  @return success
+ */
+bool ParseJobRequest(const std::string &request, Parameters &parameters);
+
+/**
+ *  @brief  Prepare the checkpoint for a job. When resuming from an existing checkpoint, truncate the written binary event files to the events
+ *          recorded, discarding any written after the checkpoint, then advance the parameters past the completed events; otherwise start a
+ *          new checkpoint.
+ *
+ *  @param  parameters the job parameters, to be updated to describe the events still to be processed
+ *  @param  pJobCheckpoint to receive the address of the checkpoint, if any
+ *
+ *  @return success
+ */
+bool PrepareCheckpoint(Parameters &parameters, std::unique_ptr<JobCheckpoint> &pJobCheckpoint);
+
+/**
+ *  @brief  Advance the parameters past a number of completed events, dropping any event files that have been read in full
+ *
+ *  @param  parameters the job parameters
+ *  @param  nEventsCompleted the number of completed events
+ *
+ *  @return success, false if the events in a file to be dropped cannot be counted
+ */
+bool AdvanceParameters(Parameters &parameters, const unsigned int nEventsCompleted);
+
+/**
+ *  @brief  Count the events in a binary (.pndr) or compressed (.pndz) event file
+ *
+ *  @param  eventFileName the event file name
+ *
+ *  @return the number of events, or -1 if the events in a file of this type cannot be counted
+ */
+int CountEvents(const std::string &eventFileName);
+
+/**
+ *  @brief  Prepare the event files for a job: start decompressing any compressed (.pndz) files, waiting for the first to complete, or for all
+ *          of them if events are to be selected or divided between threads, then resolve any event list
+ *
+ *  @param  parameters the job parameters, to be updated to describe the files to be read
+ *  @param  eventDirectory the directory for decompressed and selected event files, created if empty
+ *  @param  pEventDecompressor to receive the address of the event decompressor, if any
+ *
+ *  @return success
+ */
+bool PrepareEventFiles(Parameters &parameters, std::string &eventDirectory, std::unique_ptr<EventDecompressor> &pEventDecompressor);
+
+/**
+ *  @brief  Where possible, replace an event list, or a bounded range of events following a skip, by a new event file holding only the
+ *          selected events, so that LArEventReading need not read through the preceding events. Applies to a single binary event file,
+ *          using its index sidecar if available; a skip without an index is left to LArEventReading.
+ *
+ *  @param  parameters the parameters, to be updated to describe the selected event file
+ *  @param  eventDirectory the directory for selected event files, created if empty
+ *
+ *  @return success
+ */
+bool SelectEvents(Parameters &parameters, std::string &eventDirectory);
+
+/**
+ *  @brief  Parse an event list, a comma-separated list of event numbers or inclusive event ranges
+ *
+ *  @param  eventList the event list
+ *  @param  eventIndexList to receive the event numbers, in the order given
+ *
+ *  @return success
+ */
+bool ParseEventList(const std::string &eventList, std::vector<unsigned int> &eventIndexList);
+
+/**
+ *  @brief  Get the original event number of an event, allowing for any skip or event selection
+ *
+ *  @param  parameters the parameters
+ *  @param  eventIndex the index of the event among those processed with these parameters
+ *
+ *  @return the event number
+ */
+int GetEventNumber(const Parameters &parameters, const int eventIndex);
+
+/**
+ *  @brief  Write the index sidecar for each binary event file written by LArEventWriting during a job
+ *
+ *  @param  settingsFile the settings file
+ */
+void IndexWrittenEventFiles(const std::string &settingsFile);
+
 /**
  *  @brief  Create pandora instances
  * 
  *  @param  parameters the parameters
+ *  @param  pBinaryGeometry the address of the memory-mapped binary geometry, if any, from which to create the geometry
  *  @param  pPrimaryPandora to receive the address of the primary pandora instance
  */
-void CreatePandoraInstances(const Parameters &parameters, const pandora::Pandora *&pPrimaryPandora);
+void CreatePandoraInstances(const Parameters &parameters, const BinaryGeometry *const pBinaryGeometry, const pandora::Pandora *&pPrimaryPandora);
 
 /**
  *  @brief  Process events using the supplied pandora instances
  *
  *  @param  parameters the application parameters
  *  @param  pPrimaryPandora the address of the primary pandora instance
+ *  @param  pEventDecompressor the address of the decompressor producing the event files, if any
+ *  @param  pJobCheckpoint the address of the checkpoint to update after each completed event, if any
+ *  @param  pPfoColumnWriter the address of the writer to receive the pfos of each event, if any
+ *  @param  eventStatistics to receive the statistics for each processed event
+ */
+void ProcessEvents(const Parameters &parameters, const pandora::Pandora *const pPrimaryPandora, EventDecompressor *const pEventDecompressor,
+    JobCheckpoint *const pJobCheckpoint, PfoColumnWriter *const pPfoColumnWriter, EventStatistics &eventStatistics);
+
+/**
+ *  @brief  Process and reset a single event, recording its wall time and resident memory high-water mark
+ *
+ *  @param  parameters the application parameters
+ *  @param  pPrimaryPandora the address of the primary pandora instance
+ *  @param  eventNumber the event number, used to identify the event in reports
+ *  @param  eventFileLocator to identify the file from which the event was read
+ *  @param  pEventPrefetcher the address of the event prefetcher, if any, to wait on before processing the event
+ *  @param  pJobCheckpoint the address of the checkpoint to update once the event is complete, if any
+ *  @param  pPfoColumnWriter the address of the writer to receive the pfos of the event, if any
+ *  @param  threadIndex the index of the thread processing the event, selecting its part of the pfo column output
+ *  @param  eventStatistics to receive the statistics for the event
+ */
+void ProcessSingleEvent(const Parameters &parameters, const pandora::Pandora *const pPrimaryPandora, const int eventNumber,
+    EventFileLocator &eventFileLocator, EventPrefetcher *const pEventPrefetcher, JobCheckpoint *const pJobCheckpoint, PfoColumnWriter *const pPfoColumnWriter,
+    const unsigned int threadIndex, EventStatistics &eventStatistics);
+
+/**
+ *  @brief  Divide the input events between the event-parallel threads, providing disjoint event ranges via a parameters block per thread
+ *
+ *  @param  parameters the application parameters
+ *  @param  threadParametersList to receive the parameters for each thread, in event order
+ *
+ *  @return success
+ */
+bool GetThreadParameters(const Parameters &parameters, ParametersList &threadParametersList);
+
+/**
+ *  @brief  Process events in parallel, with one thread per primary pandora instance, then report the throughput for each thread
+ *
+ *  @param  threadParametersList the parameters for each thread
+ *  @param  primaryPandoraList the primary pandora instances, one per thread
+ *  @param  pPfoColumnWriter the address of the writer to receive the pfos of each event, if any
+ *  @param  eventStatistics to receive the statistics for each processed event
+ */
+void ProcessEventsMultiThreaded(const ParametersList &threadParametersList, const PrimaryPandoraList &primaryPandoraList,
+    PfoColumnWriter *const pPfoColumnWriter, EventStatistics &eventStatistics);
+
+/**
+ *  @brief  Process the events assigned to a single thread, capturing (rather than throwing) any exceptions
+ *
+ *  @param  parameters the parameters for this thread
+ *  @param  pPrimaryPandora the address of the primary pandora instance for this thread
+ *  @param  pPfoColumnWriter the address of the writer to receive the pfos of each event, if any
+ *  @param  threadIndex the index of this thread, in event order
+ *  @param  eventStatistics to receive the statistics for each processed event
+ *  @param  threadSummary to receive the summary of the events processed
  */
-void ProcessEvents(const Parameters &parameters, const pandora::Pandora *const pPrimaryPandora);
+void ProcessEventsInThread(const Parameters &parameters, const pandora::Pandora *const pPrimaryPandora, PfoColumnWriter *const pPfoColumnWriter,
+    const unsigned int threadIndex, EventStatistics &eventStatistics, ThreadSummary &threadSummary);
+
+/**
+ *  @brief  Print the total and per-thread event processing throughput
+ *
+ *  @param  threadSummaryList the summaries for each thread, in event order
+ *  @param  wallTime the total wall time for event processing, units s
+ */
+void DisplayThreadSummaries(const ThreadSummaryList &threadSummaryList, const double wallTime);
 
 /**
  *  @brief  Parse the command line arguments, setting the application parameters
@@ -105,9 +423,24 @@ void ProcessExternalParameters(const Parameters &parameters, const pandora::Pand
 inline Parameters::Parameters() :
     m_settingsFile(""),
     m_eventFileNameList(""),
+    m_inputFileNameList(""),
     m_geometryFileName(""),
+    m_daemonSocketName(""),
+    m_eventLogFileName(""),
+    m_profilingFileName(""),
+    m_checkpointFileName(""),
+    m_pfoFileName(""),
+    m_eventList(""),
     m_nEventsToProcess(-1),
+    m_nThreads(1),
+    m_prefetchDepth(0),
+    m_memoryBudget(0),
+    m_eventTimeLimit(0.),
+    m_eventHardTimeLimit(-1.),
     m_shouldDisplayEventNumber(false),
+    m_shouldProfileEvents(false),
+    m_shouldResume(false),
+    m_shouldUseAdaptiveSteering(false),
     m_shouldRunAllHitsCosmicReco(true),
     m_shouldRunStitching(true),
     m_shouldRunCosmicHitRemoval(true),
@@ -119,6 +452,14 @@ inline Parameters::Parameters() :
 {
 }
 
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline ThreadSummary::ThreadSummary() :
+    m_nEventsProcessed(0),
+    m_wallTime(0.)
+{
+}
+
 } // namespace lar_reco
 
 #endif // #ifndef PANDORA_INTERFACE_H
@@ -0,0 +1,181 @@
+/**
+ *  @file   LArReco/include/PfoColumnFile.h
+ *
+ *  @brief  Header file for the pfo column file class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_PFO_COLUMN_FILE_H
+#define LAR_RECO_PFO_COLUMN_FILE_H 1
+
+#include "Pandora/StatusCodes.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  PfoColumnFile class, a read-only memory mapping of a columnar pfo file, as written by the PfoColumnWriter. The file holds a header,
+ *          a directory of named columns and then the columns themselves, each a contiguous, aligned array of fixed-size values, so columns
+ *          are used in place and a scan reads only the columns it needs.
+ *
+ *          Events index their pfos via EventPfoBegin, and pfos their hits via PfoHitBegin: the pfos of event i are [EventPfoBegin[i],
+ *          EventPfoBegin[i + 1]), so each offset column holds one more entry than the events or pfos it describes. PfoParent is the index of
+ *          the parent pfo within the same event (or -1), and EventFileIndex the line of FileNames holding the event's input file list.
+ */
+class PfoColumnFile
+{
+public:
+    /**
+     *  @brief  FileHeader class, the fixed-size header at the start of a pfo column file
+     */
+    class FileHeader
+    {
+    public:
+        char                m_magic[8];                 ///< The magic number identifying the format
+        std::uint32_t       m_version;                  ///< The format version
+        std::uint32_t       m_nColumns;                 ///< The number of column records following the header
+    };
+
+    /**
+     *  @brief  ColumnRecord class, the directory entry describing a single column
+     */
+    class ColumnRecord
+    {
+    public:
+        char                m_name[32];                 ///< The column name, null-terminated
+        std::uint32_t       m_elementSize;              ///< The size of each value, units bytes
+        std::uint32_t       m_reserved;                 ///< Padding, reserved for future use
+        std::uint64_t       m_offset;                   ///< The offset of the column from the start of the file, units bytes
+        std::uint64_t       m_nElements;                ///< The number of values in the column
+    };
+
+    static const char           m_magicNumber[8];       ///< The magic number identifying the pfo column format
+    static const std::uint32_t  m_formatVersion;        ///< The current format version
+    static const std::size_t    m_columnAlignment;      ///< The alignment of each column within the file, units bytes
+
+    /**
+     *  @brief  Constructor, mapping a pfo column file into memory
+     *
+     *  @param  fileName the pfo column file name
+     */
+    PfoColumnFile(const std::string &fileName);
+
+    /**
+     *  @brief  Destructor, unmapping the file
+     */
+    ~PfoColumnFile();
+
+    /**
+     *  @brief  Deleted copy constructor
+     */
+    PfoColumnFile(const PfoColumnFile &) = delete;
+
+    /**
+     *  @brief  Deleted assignment operator
+     */
+    PfoColumnFile &operator=(const PfoColumnFile &) = delete;
+
+    /**
+     *  @brief  Get the number of columns
+     *
+     *  @return the number of columns
+     */
+    unsigned int GetNumberOfColumns() const;
+
+    /**
+     *  @brief  Get the directory entry for a column
+     *
+     *  @param  iColumn the column index
+     *
+     *  @return the column record
+     */
+    const ColumnRecord &GetColumnRecord(const unsigned int iColumn) const;
+
+    /**
+     *  @brief  Get the raw values of a column
+     *
+     *  @param  iColumn the column index
+     *
+     *  @return the address of the first byte of the column
+     */
+    const unsigned char *GetColumnBytes(const unsigned int iColumn) const;
+
+    /**
+     *  @brief  Get a column by name, checking its value size
+     *
+     *  @param  columnName the column name
+     *  @param  nElements to receive the number of values in the column
+     *
+     *  @return the address of the first value, throwing if the column is absent or of a different size
+     */
+    template <typename T>
+    const T *GetColumn(const std::string &columnName, std::size_t &nElements) const;
+
+    /**
+     *  @brief  Whether a file is in the pfo column format, as identified by its leading magic number
+     *
+     *  @param  fileName the file name
+     *
+     *  @return boolean
+     */
+    static bool IsPfoColumnFile(const std::string &fileName);
+
+private:
+    /**
+     *  @brief  Find a column by name, checking its value size
+     *
+     *  @param  columnName the column name
+     *  @param  elementSize the expected size of each value
+     *
+     *  @return the column record, throwing if the column is absent or of a different size
+     */
+    const ColumnRecord &FindColumn(const std::string &columnName, const std::size_t elementSize) const;
+
+    void                       *m_pAddress;             ///< The address of the memory mapping
+    std::size_t                 m_size;                 ///< The size of the memory mapping
+    const FileHeader           *m_pFileHeader;          ///< The address of the file header
+    const ColumnRecord         *m_pColumnRecords;       ///< The address of the first column record
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline unsigned int PfoColumnFile::GetNumberOfColumns() const
+{
+    return m_pFileHeader->m_nColumns;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const PfoColumnFile::ColumnRecord &PfoColumnFile::GetColumnRecord(const unsigned int iColumn) const
+{
+    if (iColumn >= m_pFileHeader->m_nColumns)
+        throw pandora::StatusCodeException(pandora::STATUS_CODE_OUT_OF_RANGE);
+
+    return m_pColumnRecords[iColumn];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline const unsigned char *PfoColumnFile::GetColumnBytes(const unsigned int iColumn) const
+{
+    return static_cast<const unsigned char *>(m_pAddress) + this->GetColumnRecord(iColumn).m_offset;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+inline const T *PfoColumnFile::GetColumn(const std::string &columnName, std::size_t &nElements) const
+{
+    const ColumnRecord &columnRecord(this->FindColumn(columnName, sizeof(T)));
+    nElements = columnRecord.m_nElements;
+
+    return reinterpret_cast<const T *>(static_cast<const char *>(m_pAddress) + columnRecord.m_offset);
+}
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_PFO_COLUMN_FILE_H
@@ -0,0 +1,169 @@
+/**
+ *  @file   LArReco/include/PfoColumnWriter.h
+ *
+ *  @brief  Header file for the pfo column writer class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_PFO_COLUMN_WRITER_H
+#define LAR_RECO_PFO_COLUMN_WRITER_H 1
+
+#include "Pandora/PandoraInternal.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  PfoColumnWriter class, writing the pfo hierarchy of each event to a columnar file (see PfoColumnFile). Each column is streamed to
+ *          its own temporary file as events are added, and the columns are gathered into the output file when it is closed, so memory use
+ *          does not grow with the number of events.
+ *
+ *          Events are added to one of a number of parts, each with its own temporary files, so that event-parallel threads need not share
+ *          them. The parts are gathered in order, so events added to each part in input order, by threads taking contiguous blocks of the
+ *          input, are written in input order, however the threads are scheduled.
+ */
+class PfoColumnWriter
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  fileName the name of the output pfo column file
+     *  @param  nParts the number of parts, one per event-parallel thread
+     */
+    PfoColumnWriter(const std::string &fileName, const unsigned int nParts = 1);
+
+    /**
+     *  @brief  Destructor, removing any temporary column files
+     */
+    ~PfoColumnWriter();
+
+    /**
+     *  @brief  Deleted copy constructor
+     */
+    PfoColumnWriter(const PfoColumnWriter &) = delete;
+
+    /**
+     *  @brief  Deleted assignment operator
+     */
+    PfoColumnWriter &operator=(const PfoColumnWriter &) = delete;
+
+    /**
+     *  @brief  Add the pfo hierarchy of an event, with vertices, hits and identification scores. Daughters absent from the list are added.
+     *          Different parts may be added to concurrently, but each part by only one thread at a time.
+     *
+     *  @param  partIndex the index of the part to which the event belongs
+     *  @param  eventFileNameList the colon-separated list of files from which the event was read
+     *  @param  eventNumber the event number
+     *  @param  pfoList the pfos
+     */
+    void AddEvent(const unsigned int partIndex, const std::string &eventFileNameList, const int eventNumber, const pandora::PfoList &pfoList);
+
+    /**
+     *  @brief  Write the output file from the columns of the events added so far, gathering the parts in order. Must not be called while
+     *          events are being added.
+     */
+    void Close();
+
+private:
+    /**
+     *  @brief  The columns written, in file order
+     */
+    enum ColumnIndex
+    {
+        EVENT_FILE_INDEX,
+        EVENT_NUMBER,
+        EVENT_PFO_BEGIN,
+        PFO_PDG_CODE,
+        PFO_PARENT,
+        PFO_VERTEX_X,
+        PFO_VERTEX_Y,
+        PFO_VERTEX_Z,
+        PFO_TRACK_SCORE,
+        PFO_NU_SCORE,
+        PFO_IS_CLEAR_COSMIC,
+        PFO_SLICE_INDEX,
+        PFO_HIT_BEGIN,
+        HIT_TYPE,
+        HIT_X,
+        HIT_Y,
+        HIT_Z,
+        HIT_ENERGY,
+        FILE_NAMES,
+        N_COLUMNS
+    };
+
+    /**
+     *  @brief  Column class, describing a single column and the temporary file to which it is streamed
+     */
+    class Column
+    {
+    public:
+        std::string         m_name;                     ///< The column name
+        std::uint32_t       m_elementSize;              ///< The size of each value, units bytes
+        std::string         m_fileName;                 ///< The name of the temporary column file
+        std::FILE          *m_pFile;                    ///< The temporary column file
+        std::uint64_t       m_nElements;                ///< The number of values written
+    };
+
+    typedef std::vector<Column> ColumnList;
+    typedef std::map<std::string, std::uint32_t> FileIndexMap;
+
+    /**
+     *  @brief  Part class, holding the columns of the events added to a single part, with offsets and file indices local to the part
+     */
+    class Part
+    {
+    public:
+        ColumnList                  m_columns;              ///< The columns (the file names are held in memory, so have no temporary file)
+        FileIndexMap                m_fileIndexMap;         ///< The index of each event file list in the part
+        std::vector<std::string>    m_eventFileNameLists;   ///< The event file lists, in order of their index in the part
+        std::uint64_t               m_nPfos;                ///< The number of pfos written to the part
+        std::uint64_t               m_nHits;                ///< The number of hits written to the part
+    };
+
+    typedef std::vector<Part> PartList;
+
+    /**
+     *  @brief  Append a value to a column
+     *
+     *  @param  column the column
+     *  @param  value the value
+     */
+    template <typename T>
+    static void Append(Column &column, const T &value);
+
+    /**
+     *  @brief  Copy the values of a column of a part to the output file, rebasing the offsets and file indices local to the part
+     *
+     *  @param  column the column of the part
+     *  @param  columnIndex the column index
+     *  @param  offsetBase the number of pfos (for EventPfoBegin) or hits (for PfoHitBegin) in the preceding parts
+     *  @param  fileIndices the output file index of each file index local to the part
+     *  @param  buffer the buffer through which to copy
+     *  @param  pOutputFile the output file
+     *
+     *  @return success
+     */
+    static bool CopyColumn(const Column &column, const ColumnIndex columnIndex, const std::uint64_t offsetBase,
+        const std::vector<std::uint32_t> &fileIndices, std::vector<char> &buffer, std::FILE *const pOutputFile);
+
+    /**
+     *  @brief  Close and remove the temporary column files
+     */
+    void RemoveColumnFiles();
+
+    std::string             m_fileName;                 ///< The name of the output pfo column file
+    PartList                m_parts;                    ///< The parts
+    bool                    m_isClosed;                 ///< Whether the output file has been written
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_PFO_COLUMN_WRITER_H
@@ -0,0 +1,51 @@
+/**
+ *  @file   LArReco/include/ProfilingAlgorithm.h
+ *
+ *  @brief  Header file for the profiling algorithm class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_PROFILING_ALGORITHM_H
+#define LAR_RECO_PROFILING_ALGORITHM_H 1
+
+#include "Pandora/Algorithm.h"
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  ProfilingAlgorithm class, running a single daughter algorithm and recording its wall time, call count and allocation count.
+ *          When memory monitoring or the event watchdog is enabled, the daughter algorithm is skipped once the event has exceeded its
+ *          memory budget or time limit.
+ */
+class ProfilingAlgorithm : public pandora::Algorithm
+{
+public:
+    /**
+     *  @brief  Factory class for instantiating algorithm
+     */
+    class Factory : public pandora::AlgorithmFactory
+    {
+    public:
+        pandora::Algorithm *CreateAlgorithm() const;
+    };
+
+private:
+    pandora::StatusCode Run();
+    pandora::StatusCode ReadSettings(const pandora::TiXmlHandle xmlHandle);
+
+    std::string     m_profiledAlgorithmName;    ///< The name of the profiled daughter algorithm
+    std::string     m_profiledAlgorithmType;    ///< The type of the profiled daughter algorithm, used to label the profile
+    std::string     m_stageName;                ///< The reconstruction stage begun by the daughter algorithm, for memory monitoring (if any)
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline pandora::Algorithm *ProfilingAlgorithm::Factory::CreateAlgorithm() const
+{
+    return new ProfilingAlgorithm();
+}
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_PROFILING_ALGORITHM_H
@@ -0,0 +1,44 @@
+/**
+ *  @file   LArReco/include/ProfilingMasterAlgorithm.h
+ *
+ *  @brief  Header file for the profiling master algorithm class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_PROFILING_MASTER_ALGORITHM_H
+#define LAR_RECO_PROFILING_MASTER_ALGORITHM_H 1
+
+#include "larpandoracontent/LArControlFlow/MasterAlgorithm.h"
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  ProfilingMasterAlgorithm class, a master algorithm whose worker instances can also run the LArReco profiling algorithms
+ */
+class ProfilingMasterAlgorithm : public lar_content::MasterAlgorithm
+{
+public:
+    /**
+     *  @brief  Factory class for instantiating algorithm
+     */
+    class Factory : public pandora::AlgorithmFactory
+    {
+    public:
+        pandora::Algorithm *CreateAlgorithm() const;
+    };
+
+private:
+    pandora::StatusCode RegisterCustomContent(const pandora::Pandora *const pPandora) const;
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+inline pandora::Algorithm *ProfilingMasterAlgorithm::Factory::CreateAlgorithm() const
+{
+    return new ProfilingMasterAlgorithm();
+}
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_PROFILING_MASTER_ALGORITHM_H
@@ -0,0 +1,151 @@
+/**
+ *  @file   LArReco/include/SettingsHelper.h
+ *
+ *  @brief  Header file for the settings helper class.
+ *
+ *  $Log: $
+ */
+#ifndef LAR_RECO_SETTINGS_HELPER_H
+#define LAR_RECO_SETTINGS_HELPER_H 1
+
+#include <string>
+#include <vector>
+
+namespace pandora {class TiXmlElement; class TiXmlNode;}
+
+namespace lar_reco
+{
+
+/**
+ *  @brief  SettingsHelper class, providing utilities for locating and rewriting pandora settings files
+ */
+class SettingsHelper
+{
+public:
+    /**
+     *  @brief  SettingsTree class, describing a settings file together with the LArMaster worker settings files that it references
+     */
+    class SettingsTree
+    {
+    public:
+        std::vector<std::string>    m_sourceFiles;              ///< The qualified names of all settings files read, starting with the top-level file
+        std::vector<std::string>    m_searchPathVariables;      ///< The environment variables via which worker settings files are located
+    };
+
+    /**
+     *  @brief  Find a file in the colon-separated list of directories given by an environment variable, as for the LArMaster worker settings
+     *
+     *  @param  unqualifiedFileName the unqualified file name
+     *  @param  environmentVariable the name of the environment variable
+     *
+     *  @return the qualified file name, throwing if the file cannot be found
+     */
+    static std::string FindFileInPath(const std::string &unqualifiedFileName, const std::string &environmentVariable);
+
+    /**
+     *  @brief  Get the unqualified name of a file
+     *
+     *  @param  fileName the file name
+     *
+     *  @return the unqualified file name
+     */
+    static std::string GetBaseName(const std::string &fileName);
+
+    /**
+     *  @brief  Create a new, uniquely named temporary directory
+     *
+     *  @param  parentDirectory the directory in which to create the temporary directory (the system temporary directory if empty)
+     *
+     *  @return the name of the temporary directory
+     */
+    static std::string CreateTemporaryDirectory(const std::string &parentDirectory = "");
+
+    /**
+     *  @brief  Remove a directory and all of its contents
+     *
+     *  @param  directoryName the name of the directory
+     */
+    static void RemoveDirectory(const std::string &directoryName);
+
+    /**
+     *  @brief  Validate a settings file, and any LArMaster worker settings files, writing compact copies (without comments or formatting)
+     *          to an output directory. Worker settings files keep their unqualified names, so PrependSearchPath must be used to ensure that
+     *          the copies are found in preference to the originals.
+     *
+     *  @param  settingsFile the settings file
+     *  @param  outputDirectory the directory in which to write the rewritten settings files
+     *  @param  shouldProfile whether to wrap every algorithm in a profiling algorithm, retyping LArMaster so that its workers can do likewise
+     *  @param  stageName the reconstruction stage to which the top-level algorithms belong, for memory monitoring (if empty, each top-level
+     *          algorithm is a stage, named by its type)
+     *  @param  settingsTree to receive the description of the settings files read
+     *
+     *  @return the name of the rewritten settings file
+     */
+    static std::string RewriteSettings(const std::string &settingsFile, const std::string &outputDirectory, const bool shouldProfile,
+        const std::string &stageName, SettingsTree &settingsTree);
+
+    /**
+     *  @brief  Prepend a directory to the search path for each of the worker settings environment variables in a settings tree
+     *
+     *  @param  settingsTree the settings tree
+     *  @param  directoryName the directory name
+     */
+    static void PrependSearchPath(const SettingsTree &settingsTree, const std::string &directoryName);
+
+    /**
+     *  @brief  Get the binary event files written by any LArEventWriting algorithms in a settings file
+     *
+     *  @param  settingsFile the settings file
+     *  @param  eventFileNames to receive the names of the binary event files
+     */
+    static void GetWrittenEventFiles(const std::string &settingsFile, std::vector<std::string> &eventFileNames);
+
+    /**
+     *  @brief  Get the binary event files written by any LArEventWriting algorithms in a settings file that replace, rather than append to,
+     *          existing files
+     *
+     *  @param  settingsFile the settings file
+     *  @param  eventFileNames to receive the names of the overwritten binary event files
+     */
+    static void GetOverwrittenEventFiles(const std::string &settingsFile, std::vector<std::string> &eventFileNames);
+
+private:
+    /**
+     *  @brief  Process the elements below a parent element, removing comments, validating and (optionally) wrapping algorithm elements and
+     *          rewriting the worker settings files referenced by any LArMaster algorithm
+     *
+     *  @param  pParentElement the address of the parent element
+     *  @param  outputDirectory the directory in which to write any rewritten worker settings files
+     *  @param  shouldProfile whether to wrap every algorithm in a profiling algorithm
+     *  @param  isTopLevel whether the parent element is the root element of a settings file
+     *  @param  stageName the reconstruction stage to which the top-level algorithms belong (each its own stage if empty)
+     *  @param  settingsTree to receive the description of the settings files read
+     */
+    static void ProcessElements(pandora::TiXmlElement *const pParentElement, const std::string &outputDirectory, const bool shouldProfile,
+        const bool isTopLevel, const std::string &stageName, SettingsTree &settingsTree);
+
+    /**
+     *  @brief  Rewrite the worker settings files referenced by a LArMaster algorithm element. Each worker settings file is a reconstruction
+     *          stage, named by its element (e.g. CR for CRSettingsFile).
+     *
+     *  @param  pMasterElement the address of the LArMaster algorithm element
+     *  @param  outputDirectory the directory in which to write the rewritten settings files
+     *  @param  shouldProfile whether to wrap every algorithm in a profiling algorithm
+     *  @param  settingsTree to receive the description of the settings files read
+     */
+    static void ProcessMasterAlgorithm(pandora::TiXmlElement *const pMasterElement, const std::string &outputDirectory, const bool shouldProfile,
+        SettingsTree &settingsTree);
+
+    /**
+     *  @brief  Collect the binary event files written by any LArEventWriting algorithms at or below a given element
+     *
+     *  @param  pElement the address of the element
+     *  @param  overwrittenOnly whether to collect only the files that replace, rather than append to, existing files
+     *  @param  eventFileNames to receive the names of the binary event files
+     */
+    static void CollectWrittenEventFiles(const pandora::TiXmlElement *const pElement, const bool overwrittenOnly, std::vector<std::string> &eventFileNames);
+};
+
+} // namespace lar_reco
+
+#endif // #ifndef LAR_RECO_SETTINGS_HELPER_H
@@ -0,0 +1,111 @@
+/**
+ *  @file   LArReco/src/AdaptiveMasterAlgorithm.cxx
+ *
+ *  @brief  Implementation of the adaptive master algorithm class.
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/AlgorithmHeaders.h"
+
+#include "larpandoracontent/LArObjects/LArCaloHit.h"
+
+#include "AdaptiveMasterAlgorithm.h"
+
+#include <iostream>
+#include <map>
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+AdaptiveMasterAlgorithm::AdaptiveMasterAlgorithm() :
+    m_shouldPrintChosenPath(true)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode AdaptiveMasterAlgorithm::Run()
+{
+    IntVector nHitsPerView;
+    std::map<unsigned int, int> nHitsPerVolume;
+
+    for (const std::string &caloHitListName : m_caloHitListNames)
+    {
+        const CaloHitList *pCaloHitList(nullptr);
+        PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_INITIALIZED, !=, PandoraContentApi::GetList(*this, caloHitListName, pCaloHitList));
+        nHitsPerView.push_back(pCaloHitList ? static_cast<int>(pCaloHitList->size()) : 0);
+
+        if (!pCaloHitList)
+            continue;
+
+        for (const CaloHit *const pCaloHit : *pCaloHitList)
+        {
+            const lar_content::LArCaloHit *const pLArCaloHit(dynamic_cast<const lar_content::LArCaloHit *>(pCaloHit));
+
+            if (pLArCaloHit)
+                ++nHitsPerVolume[pLArCaloHit->GetLArTPCVolumeId()];
+        }
+    }
+
+    int maxHitsPerView(0), maxHitsPerVolume(0);
+
+    for (const int nHits : nHitsPerView)
+        maxHitsPerView = std::max(maxHitsPerView, nHits);
+
+    for (const auto &mapEntry : nHitsPerVolume)
+        maxHitsPerVolume = std::max(maxHitsPerVolume, mapEntry.second);
+
+    // ATTN The last path has no thresholds, so is chosen for any event that exceeds the thresholds of all the others
+    unsigned int chosenPath(0);
+
+    while ((chosenPath + 1 < m_pathAlgorithmNames.size()) &&
+        ((maxHitsPerView > m_maxHitsPerView.at(chosenPath)) || (maxHitsPerVolume > m_maxHitsPerVolume.at(chosenPath))))
+    {
+        ++chosenPath;
+    }
+
+    if (m_shouldPrintChosenPath)
+    {
+        std::cout << "AdaptiveMasterAlgorithm - hits per view";
+
+        for (const int nHits : nHitsPerView)
+            std::cout << " " << nHits;
+
+        std::cout << ", max hits per volume " << maxHitsPerVolume << " (" << nHitsPerVolume.size() << " volumes), running path "
+                  << m_pathNames.at(chosenPath) << std::endl;
+    }
+
+    return PandoraContentApi::RunDaughterAlgorithm(*this, m_pathAlgorithmNames.at(chosenPath));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode AdaptiveMasterAlgorithm::ReadSettings(const TiXmlHandle xmlHandle)
+{
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadVectorOfValues(xmlHandle, "CaloHitListNames", m_caloHitListNames));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ProcessAlgorithmList(*this, xmlHandle, "RecoPaths", m_pathAlgorithmNames));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadVectorOfValues(xmlHandle, "PathNames", m_pathNames));
+
+    if (m_pathAlgorithmNames.size() > 1)
+    {
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadVectorOfValues(xmlHandle, "MaxHitsPerView", m_maxHitsPerView));
+        PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadVectorOfValues(xmlHandle, "MaxHitsPerVolume", m_maxHitsPerVolume));
+    }
+
+    if (m_pathAlgorithmNames.empty() || (m_pathNames.size() != m_pathAlgorithmNames.size()) ||
+        (m_maxHitsPerView.size() + 1 != m_pathAlgorithmNames.size()) || (m_maxHitsPerVolume.size() + 1 != m_pathAlgorithmNames.size()))
+    {
+        std::cout << "AdaptiveMasterAlgorithm::ReadSettings - expect one path name per reco path, and thresholds for all paths but the last" << std::endl;
+        return STATUS_CODE_INVALID_PARAMETER;
+    }
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "ShouldPrintChosenPath", m_shouldPrintChosenPath));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+} // namespace lar_reco
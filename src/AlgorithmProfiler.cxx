@@ -0,0 +1,290 @@
+/**
+ *  @file   LArReco/src/AlgorithmProfiler.cxx
+ *
+ *  @brief  Implementation of the algorithm profiler class.
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/StatusCodes.h"
+
+#include "AlgorithmProfiler.h"
+#include "AllocationCounter.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace pandora;
+
+namespace
+{
+
+/**
+ *  @brief  ScopeFrame class, describing an algorithm call in progress on the current thread
+ */
+class ScopeFrame
+{
+public:
+    std::string                                         m_path;                 ///< The nesting path of the algorithm
+    std::chrono::steady_clock::time_point               m_startTime;            ///< The start time of the call
+    unsigned long long                                  m_startAllocations;     ///< The thread allocation count at the start of the call
+    double                                              m_daughterTime;         ///< The wall time spent in profiled daughter algorithms
+    unsigned long long                                  m_daughterAllocations;  ///< The allocations made in profiled daughter algorithms
+};
+
+thread_local std::vector<ScopeFrame> g_scopeFrames;                             ///< The algorithm calls in progress on the current thread
+thread_local lar_reco::AlgorithmProfiler::ProfileMap g_eventProfileMap;         ///< The algorithm profiles for the current event on this thread
+
+/**
+ *  @brief  Escape a string for inclusion in a json document
+ *
+ *  @param  input the input string
+ *
+ *  @return the escaped string
+ */
+std::string JsonEscape(const std::string &input)
+{
+    std::string output;
+
+    for (const char c : input)
+    {
+        if (('"' == c) || ('\\' == c))
+            output += '\\';
+
+        output += c;
+    }
+
+    return output;
+}
+
+/**
+ *  @brief  Write a profile map as a json array
+ *
+ *  @param  profileMap the profile map
+ *  @param  indent the indentation for each array entry
+ *  @param  outputFile the output file stream
+ */
+void WriteJsonProfileMap(const lar_reco::AlgorithmProfiler::ProfileMap &profileMap, const std::string &indent, std::ofstream &outputFile)
+{
+    outputFile << "[" << std::endl;
+
+    for (auto iter = profileMap.begin(); iter != profileMap.end(); ++iter)
+    {
+        const lar_reco::AlgorithmProfiler::ProfileEntry &entry(iter->second);
+        outputFile << indent << "{\"algorithm\": \"" << JsonEscape(iter->first) << "\", \"calls\": " << entry.m_nCalls
+                   << ", \"inclusiveTime\": " << entry.m_inclusiveTime << ", \"exclusiveTime\": " << entry.m_exclusiveTime
+                   << ", \"allocations\": " << entry.m_nAllocations << ", \"exclusiveAllocations\": " << entry.m_nExclusiveAllocations << "}"
+                   << ((std::next(iter) != profileMap.end()) ? "," : "") << std::endl;
+    }
+
+    outputFile << indent.substr(4) << "]";
+}
+
+/**
+ *  @brief  Write a profile map as csv rows
+ *
+ *  @param  prefix the leading columns for each row
+ *  @param  profileMap the profile map
+ *  @param  outputFile the output file stream
+ */
+void WriteCsvProfileMap(const std::string &prefix, const lar_reco::AlgorithmProfiler::ProfileMap &profileMap, std::ofstream &outputFile)
+{
+    for (const auto &mapEntry : profileMap)
+    {
+        const lar_reco::AlgorithmProfiler::ProfileEntry &entry(mapEntry.second);
+        outputFile << prefix << mapEntry.first << "," << entry.m_nCalls << "," << entry.m_inclusiveTime << "," << entry.m_exclusiveTime << ","
+                   << entry.m_nAllocations << "," << entry.m_nExclusiveAllocations << std::endl;
+    }
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+AlgorithmProfiler::Scope::Scope(const std::string &algorithmType)
+{
+    ScopeFrame scopeFrame;
+    scopeFrame.m_path = g_scopeFrames.empty() ? algorithmType : g_scopeFrames.back().m_path + "/" + algorithmType;
+    scopeFrame.m_daughterTime = 0.;
+    scopeFrame.m_daughterAllocations = 0;
+    g_scopeFrames.push_back(std::move(scopeFrame));
+
+    // ATTN Sample the counters last, so that the bookkeeping above is not attributed to the algorithm
+    g_scopeFrames.back().m_startAllocations = AllocationCounter::GetThreadAllocationCount();
+    g_scopeFrames.back().m_startTime = std::chrono::steady_clock::now();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+AlgorithmProfiler::Scope::~Scope()
+{
+    const auto endTime(std::chrono::steady_clock::now());
+    const unsigned long long endAllocations(AllocationCounter::GetThreadAllocationCount());
+
+    const ScopeFrame &scopeFrame(g_scopeFrames.back());
+    const double inclusiveTime(std::chrono::duration<double>(endTime - scopeFrame.m_startTime).count());
+    const unsigned long long nAllocations(endAllocations - scopeFrame.m_startAllocations);
+
+    ProfileEntry &entry(g_eventProfileMap[scopeFrame.m_path]);
+    ++entry.m_nCalls;
+    entry.m_inclusiveTime += inclusiveTime;
+    entry.m_exclusiveTime += inclusiveTime - scopeFrame.m_daughterTime;
+    entry.m_nAllocations += nAllocations;
+    entry.m_nExclusiveAllocations += nAllocations - std::min(nAllocations, scopeFrame.m_daughterAllocations);
+
+    g_scopeFrames.pop_back();
+
+    if (!g_scopeFrames.empty())
+    {
+        g_scopeFrames.back().m_daughterTime += inclusiveTime;
+        g_scopeFrames.back().m_daughterAllocations += nAllocations;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+AlgorithmProfiler &AlgorithmProfiler::GetInstance()
+{
+    static AlgorithmProfiler algorithmProfiler;
+    return algorithmProfiler;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void AlgorithmProfiler::SetShouldStoreEvents(const bool shouldStoreEvents)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shouldStoreEvents = shouldStoreEvents;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void AlgorithmProfiler::EndEvent(const std::string &eventFileNameList, const int eventNumber)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ++m_nEvents;
+
+    for (const auto &mapEntry : g_eventProfileMap)
+        m_profileMap[mapEntry.first].Add(mapEntry.second);
+
+    if (m_shouldStoreEvents)
+    {
+        EventProfile eventProfile;
+        eventProfile.m_eventFileNameList = eventFileNameList;
+        eventProfile.m_eventNumber = eventNumber;
+        eventProfile.m_profileMap.swap(g_eventProfileMap);
+        m_eventProfileList.push_back(std::move(eventProfile));
+    }
+
+    g_eventProfileMap.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void AlgorithmProfiler::WriteReport(const std::string &fileName) const
+{
+    const std::string jsonExtension(".json");
+
+    if ((fileName.size() > jsonExtension.size()) && (0 == fileName.compare(fileName.size() - jsonExtension.size(), jsonExtension.size(), jsonExtension)))
+    {
+        this->WriteJsonReport(fileName);
+    }
+    else
+    {
+        this->WriteCsvReport(fileName);
+    }
+
+    std::cout << "LArReco, algorithm profile for " << m_nEvents << " events written to " << fileName << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void AlgorithmProfiler::Reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_nEvents = 0;
+    m_profileMap.clear();
+    m_eventProfileList.clear();
+    g_eventProfileMap.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+AlgorithmProfiler::AlgorithmProfiler() :
+    m_shouldStoreEvents(false),
+    m_nEvents(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void AlgorithmProfiler::WriteCsvReport(const std::string &fileName) const
+{
+    std::ofstream outputFile(fileName);
+
+    if (!outputFile)
+    {
+        std::cout << "AlgorithmProfiler, unable to open output file " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    outputFile << std::setprecision(9) << "Files,Event,Algorithm,Calls,InclusiveTime,ExclusiveTime,Allocations,ExclusiveAllocations" << std::endl;
+    WriteCsvProfileMap("All,-1,", m_profileMap, outputFile);
+
+    EventProfileList eventProfileList(m_eventProfileList);
+    std::sort(eventProfileList.begin(), eventProfileList.end(), [](const EventProfile &lhs, const EventProfile &rhs) {
+        return (lhs.m_eventFileNameList != rhs.m_eventFileNameList) ? (lhs.m_eventFileNameList < rhs.m_eventFileNameList)
+                                                                    : (lhs.m_eventNumber < rhs.m_eventNumber);
+    });
+
+    for (const EventProfile &eventProfile : eventProfileList)
+        WriteCsvProfileMap(eventProfile.m_eventFileNameList + "," + std::to_string(eventProfile.m_eventNumber) + ",", eventProfile.m_profileMap, outputFile);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void AlgorithmProfiler::WriteJsonReport(const std::string &fileName) const
+{
+    std::ofstream outputFile(fileName);
+
+    if (!outputFile)
+    {
+        std::cout << "AlgorithmProfiler, unable to open output file " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    outputFile << std::setprecision(9) << "{" << std::endl << "    \"nEvents\": " << m_nEvents << "," << std::endl << "    \"algorithms\": ";
+    WriteJsonProfileMap(m_profileMap, "        ", outputFile);
+
+    if (m_shouldStoreEvents)
+    {
+        EventProfileList eventProfileList(m_eventProfileList);
+        std::sort(eventProfileList.begin(), eventProfileList.end(), [](const EventProfile &lhs, const EventProfile &rhs) {
+            return (lhs.m_eventFileNameList != rhs.m_eventFileNameList) ? (lhs.m_eventFileNameList < rhs.m_eventFileNameList)
+                                                                        : (lhs.m_eventNumber < rhs.m_eventNumber);
+        });
+
+        outputFile << "," << std::endl << "    \"events\": [" << std::endl;
+
+        for (auto iter = eventProfileList.begin(); iter != eventProfileList.end(); ++iter)
+        {
+            outputFile << "        {\"files\": \"" << JsonEscape(iter->m_eventFileNameList) << "\", \"event\": " << iter->m_eventNumber
+                       << ", \"algorithms\": ";
+            WriteJsonProfileMap(iter->m_profileMap, "            ", outputFile);
+            outputFile << "}" << ((std::next(iter) != eventProfileList.end()) ? "," : "") << std::endl;
+        }
+
+        outputFile << "    ]";
+    }
+
+    outputFile << std::endl << "}" << std::endl;
+}
+
+} // namespace lar_reco
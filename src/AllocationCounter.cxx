@@ -0,0 +1,115 @@
+/**
+ *  @file   LArReco/src/AllocationCounter.cxx
+ *
+ *  @brief  Implementation of the allocation counter, including the replacement global operator new and operator delete.
+ *
+ *  $Log: $
+ */
+
+#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+
+thread_local unsigned long long g_nThreadAllocations(0);    ///< The number of heap allocations made by the current thread
+
+/**
+ *  @brief  Allocate memory, following the standard operator new contract (retry via the new handler, then throw)
+ *
+ *  @param  size the number of bytes to allocate
+ *
+ *  @return the address of the allocated memory
+ */
+void *Allocate(std::size_t size)
+{
+    ++g_nThreadAllocations;
+
+    if (0 == size)
+        size = 1;
+
+    while (true)
+    {
+        if (void *const pMemory = std::malloc(size))
+            return pMemory;
+
+        const std::new_handler newHandler(std::get_new_handler());
+
+        if (!newHandler)
+            throw std::bad_alloc();
+
+        newHandler();
+    }
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void *operator new(std::size_t size)
+{
+    return Allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return Allocate(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return Allocate(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    try
+    {
+        return Allocate(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void operator delete(void *pMemory) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete[](void *pMemory) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete(void *pMemory, std::size_t) noexcept
+{
+    std::free(pMemory);
+}
+
+void operator delete[](void *pMemory, std::size_t) noexcept
+{
+    std::free(pMemory);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+unsigned long long AllocationCounter::GetThreadAllocationCount()
+{
+    return g_nThreadAllocations;
+}
+
+} // namespace lar_reco
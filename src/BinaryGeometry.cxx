@@ -0,0 +1,223 @@
+/**
+ *  @file   LArReco/src/BinaryGeometry.cxx
+ *
+ *  @brief  Implementation of the binary geometry class.
+ *
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+#include "Helpers/XmlHelper.h"
+#include "Xml/tinyxml.h"
+
+#include "BinaryGeometry.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+const char BinaryGeometry::m_magicNumber[8] = {'L', 'A', 'R', 'G', 'E', 'O', 'M', '\n'};
+const std::uint32_t BinaryGeometry::m_formatVersion(1);
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+BinaryGeometry::BinaryGeometry(const std::string &fileName) :
+    m_pAddress(nullptr),
+    m_size(0),
+    m_pFileHeader(nullptr),
+    m_pLArTPCRecords(nullptr),
+    m_pLineGapRecords(nullptr)
+{
+    static_assert((24 == sizeof(FileHeader)) && (60 == sizeof(LArTPCRecord)) && (20 == sizeof(LineGapRecord)), "BinaryGeometry: unexpected record size");
+
+    const int fd(open(fileName.c_str(), O_RDONLY));
+    struct stat fileStat;
+
+    if ((fd < 0) || (0 != fstat(fd, &fileStat)) || (static_cast<std::size_t>(fileStat.st_size) < sizeof(FileHeader)))
+    {
+        if (fd >= 0)
+            close(fd);
+
+        std::cout << "BinaryGeometry - unable to read " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+    }
+
+    m_size = fileStat.st_size;
+    m_pAddress = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (MAP_FAILED == m_pAddress)
+    {
+        std::cout << "BinaryGeometry - unable to map " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    // ATTN The mapping is page-aligned and all records are multiples of four bytes, so the records can be used in place
+    const char *const pBytes(static_cast<const char *>(m_pAddress));
+    m_pFileHeader = reinterpret_cast<const FileHeader *>(pBytes);
+
+    const std::size_t expectedSize(sizeof(FileHeader) + m_pFileHeader->m_nLArTPCs * sizeof(LArTPCRecord) + m_pFileHeader->m_nLineGaps * sizeof(LineGapRecord));
+
+    if ((0 != std::memcmp(m_pFileHeader->m_magic, m_magicNumber, sizeof(m_magicNumber))) || (m_formatVersion != m_pFileHeader->m_version) ||
+        (expectedSize != m_size))
+    {
+        munmap(m_pAddress, m_size);
+        std::cout << "BinaryGeometry - invalid or unsupported binary geometry file " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    m_pLArTPCRecords = reinterpret_cast<const LArTPCRecord *>(pBytes + sizeof(FileHeader));
+    m_pLineGapRecords = reinterpret_cast<const LineGapRecord *>(pBytes + sizeof(FileHeader) + m_pFileHeader->m_nLArTPCs * sizeof(LArTPCRecord));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+BinaryGeometry::~BinaryGeometry()
+{
+    munmap(m_pAddress, m_size);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void BinaryGeometry::CreateGeometry(const Pandora &pandora) const
+{
+    for (std::uint32_t iLArTPC = 0; iLArTPC < m_pFileHeader->m_nLArTPCs; ++iLArTPC)
+    {
+        const LArTPCRecord &record(m_pLArTPCRecords[iLArTPC]);
+
+        PandoraApi::Geometry::LArTPC::Parameters parameters;
+        parameters.m_larTPCVolumeId = record.m_larTPCVolumeId;
+        parameters.m_centerX = record.m_center[0];
+        parameters.m_centerY = record.m_center[1];
+        parameters.m_centerZ = record.m_center[2];
+        parameters.m_widthX = record.m_width[0];
+        parameters.m_widthY = record.m_width[1];
+        parameters.m_widthZ = record.m_width[2];
+        parameters.m_wirePitchU = record.m_wirePitch[0];
+        parameters.m_wirePitchV = record.m_wirePitch[1];
+        parameters.m_wirePitchW = record.m_wirePitch[2];
+        parameters.m_wireAngleU = record.m_wireAngle[0];
+        parameters.m_wireAngleV = record.m_wireAngle[1];
+        parameters.m_wireAngleW = record.m_wireAngle[2];
+        parameters.m_sigmaUVW = record.m_sigmaUVW;
+        parameters.m_isDriftInPositiveX = (0 != record.m_isDriftInPositiveX);
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Geometry::LArTPC::Create(pandora, parameters));
+    }
+
+    for (std::uint32_t iLineGap = 0; iLineGap < m_pFileHeader->m_nLineGaps; ++iLineGap)
+    {
+        const LineGapRecord &record(m_pLineGapRecords[iLineGap]);
+
+        PandoraApi::Geometry::LineGap::Parameters parameters;
+        parameters.m_lineGapType = static_cast<LineGapType>(record.m_lineGapType);
+        parameters.m_lineStartX = record.m_lineStartX;
+        parameters.m_lineEndX = record.m_lineEndX;
+        parameters.m_lineStartZ = record.m_lineStartZ;
+        parameters.m_lineEndZ = record.m_lineEndZ;
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Geometry::LineGap::Create(pandora, parameters));
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool BinaryGeometry::IsBinaryGeometryFile(const std::string &fileName)
+{
+    char magic[sizeof(m_magicNumber)] = {0};
+    std::ifstream inputFile(fileName, std::ios::binary);
+
+    return (inputFile.read(magic, sizeof(magic)) && (0 == std::memcmp(magic, m_magicNumber, sizeof(m_magicNumber))));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void BinaryGeometry::ConvertXmlGeometry(const std::string &xmlFileName, const std::string &binaryFileName)
+{
+    TiXmlDocument xmlDocument(xmlFileName);
+
+    if (!xmlDocument.LoadFile())
+    {
+        std::cout << "BinaryGeometry - invalid xml file " << xmlFileName << ", " << xmlDocument.ErrorDesc() << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    std::vector<LArTPCRecord> larTPCRecords;
+    std::vector<LineGapRecord> lineGapRecords;
+
+    for (TiXmlElement *pElement = xmlDocument.RootElement() ? xmlDocument.RootElement()->FirstChildElement() : nullptr; nullptr != pElement;
+         pElement = pElement->NextSiblingElement())
+    {
+        const TiXmlHandle xmlHandle(pElement);
+
+        if ("LArTPC" == pElement->ValueStr())
+        {
+            LArTPCRecord record;
+            bool isDriftInPositiveX(false);
+            unsigned int larTPCVolumeId(0);
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "LArTPCVolumeId", larTPCVolumeId));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "CenterX", record.m_center[0]));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "CenterY", record.m_center[1]));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "CenterZ", record.m_center[2]));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "WidthX", record.m_width[0]));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "WidthY", record.m_width[1]));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "WidthZ", record.m_width[2]));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "WirePitchU", record.m_wirePitch[0]));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "WirePitchV", record.m_wirePitch[1]));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "WirePitchW", record.m_wirePitch[2]));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "WireAngleU", record.m_wireAngle[0]));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "WireAngleV", record.m_wireAngle[1]));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "WireAngleW", record.m_wireAngle[2]));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "SigmaUVW", record.m_sigmaUVW));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "IsDriftInPositiveX", isDriftInPositiveX));
+            record.m_larTPCVolumeId = larTPCVolumeId;
+            record.m_isDriftInPositiveX = isDriftInPositiveX ? 1 : 0;
+            larTPCRecords.push_back(record);
+        }
+        else if ("LineGap" == pElement->ValueStr())
+        {
+            LineGapRecord record;
+            unsigned int lineGapType(0);
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "LineGapType", lineGapType));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "LineStartX", record.m_lineStartX));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "LineEndX", record.m_lineEndX));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "LineStartZ", record.m_lineStartZ));
+            PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "LineEndZ", record.m_lineEndZ));
+            record.m_lineGapType = lineGapType;
+            lineGapRecords.push_back(record);
+        }
+        else
+        {
+            std::cout << "BinaryGeometry - unrecognised geometry element " << pElement->ValueStr() << " in " << xmlFileName << std::endl;
+            throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+        }
+    }
+
+    FileHeader fileHeader;
+    std::memcpy(fileHeader.m_magic, m_magicNumber, sizeof(m_magicNumber));
+    fileHeader.m_version = m_formatVersion;
+    fileHeader.m_nLArTPCs = larTPCRecords.size();
+    fileHeader.m_nLineGaps = lineGapRecords.size();
+    fileHeader.m_reserved = 0;
+
+    std::ofstream outputFile(binaryFileName, std::ios::binary);
+    outputFile.write(reinterpret_cast<const char *>(&fileHeader), sizeof(FileHeader));
+    outputFile.write(reinterpret_cast<const char *>(larTPCRecords.data()), larTPCRecords.size() * sizeof(LArTPCRecord));
+    outputFile.write(reinterpret_cast<const char *>(lineGapRecords.data()), lineGapRecords.size() * sizeof(LineGapRecord));
+
+    if (!outputFile)
+    {
+        std::cout << "BinaryGeometry - unable to write " << binaryFileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+}
+
+} // namespace lar_reco
@@ -0,0 +1,255 @@
+/**
+ *  @file   LArReco/src/CompressedEventFile.cxx
+ *
+ *  @brief  Implementation of the compressed event file class.
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/StatusCodes.h"
+
+#include "CompressedEventFile.h"
+#include "EventFileHelper.h"
+#include "SettingsHelper.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#ifdef LAR_RECO_ZSTD
+#include <zstd.h>
+#endif
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+const char CompressedEventFile::m_magicNumber[8] = {'L', 'A', 'R', 'P', 'N', 'D', 'Z', '\n'};
+const std::uint32_t CompressedEventFile::m_formatVersion = 1;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool CompressedEventFile::IsCompressedFile(const std::string &fileName)
+{
+    const std::string compressedExtension(".pndz");
+
+    return ((fileName.size() > compressedExtension.size()) &&
+        (0 == fileName.compare(fileName.size() - compressedExtension.size(), compressedExtension.size(), compressedExtension)));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string CompressedEventFile::GetBinaryBaseName(const std::string &fileName)
+{
+    const std::string baseName(SettingsHelper::GetBaseName(fileName));
+
+    return (IsCompressedFile(baseName) ? baseName.substr(0, baseName.size() - 1) + "r" : baseName);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef LAR_RECO_ZSTD
+void CompressedEventFile::Compress(const std::string &inputFileName, const std::string &outputFileName, const int compressionLevel)
+{
+    static_assert(24 == sizeof(FileHeader), "CompressedEventFile: unexpected file header size");
+    static_assert(24 == sizeof(BlockHeader), "CompressedEventFile: unexpected block header size");
+
+    const int inputFd(open(inputFileName.c_str(), O_RDONLY));
+    struct stat fileStat;
+
+    if ((inputFd < 0) || (0 != fstat(inputFd, &fileStat)))
+    {
+        if (inputFd >= 0)
+            close(inputFd);
+
+        std::cout << "CompressedEventFile::Compress - unable to open " << inputFileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+    }
+
+    std::ofstream outputFile(outputFileName, std::ios::binary);
+    FileHeader fileHeader;
+    std::memset(&fileHeader, 0, sizeof(FileHeader));
+    std::memcpy(fileHeader.m_magic, m_magicNumber, sizeof(m_magicNumber));
+    fileHeader.m_version = m_formatVersion;
+    fileHeader.m_compressionLevel = compressionLevel;
+    outputFile.write(reinterpret_cast<const char *>(&fileHeader), sizeof(FileHeader));
+
+    const std::uint64_t fileSize(fileStat.st_size);
+    std::vector<char> inputBuffer, outputBuffer;
+    bool success(true);
+
+    for (std::uint64_t offset = 0; success && (offset < fileSize);)
+    {
+        BlockHeader blockHeader;
+        std::memset(&blockHeader, 0, sizeof(BlockHeader));
+        bool isEventContainer(false);
+
+        if (!EventFileHelper::ReadContainerHeader(inputFd, offset, isEventContainer, blockHeader.m_uncompressedSize) ||
+            (offset + blockHeader.m_uncompressedSize > fileSize))
+        {
+            std::cout << "CompressedEventFile::Compress - invalid container at byte " << offset << " in " << inputFileName << std::endl;
+            success = false;
+            break;
+        }
+
+        inputBuffer.resize(blockHeader.m_uncompressedSize);
+        outputBuffer.resize(ZSTD_compressBound(inputBuffer.size()));
+
+        if (static_cast<ssize_t>(inputBuffer.size()) != pread(inputFd, inputBuffer.data(), inputBuffer.size(), offset))
+        {
+            success = false;
+            break;
+        }
+
+        const std::size_t compressedSize(ZSTD_compress(outputBuffer.data(), outputBuffer.size(), inputBuffer.data(), inputBuffer.size(), compressionLevel));
+
+        if (ZSTD_isError(compressedSize))
+        {
+            std::cout << "CompressedEventFile::Compress - " << ZSTD_getErrorName(compressedSize) << std::endl;
+            success = false;
+            break;
+        }
+
+        blockHeader.m_compressedSize = compressedSize;
+        blockHeader.m_isEventContainer = isEventContainer ? 1 : 0;
+        outputFile.write(reinterpret_cast<const char *>(&blockHeader), sizeof(BlockHeader));
+        outputFile.write(outputBuffer.data(), compressedSize);
+
+        ++fileHeader.m_nBlocks;
+        offset += blockHeader.m_uncompressedSize;
+    }
+
+    close(inputFd);
+
+    // ATTN The block count is only known once all containers have been compressed
+    outputFile.seekp(0);
+    outputFile.write(reinterpret_cast<const char *>(&fileHeader), sizeof(FileHeader));
+
+    if (!success || !outputFile.flush())
+    {
+        std::cout << "CompressedEventFile::Compress - unable to write " << outputFileName << std::endl;
+        outputFile.close();
+        std::remove(outputFileName.c_str());
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+}
+#else
+void CompressedEventFile::Compress(const std::string &, const std::string &, const int)
+{
+    std::cout << "CompressedEventFile::Compress - LArReco was built without zstd support (LAR_RECO_ZSTD)" << std::endl;
+    throw StatusCodeException(STATUS_CODE_NOT_ALLOWED);
+}
+#endif
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void CompressedEventFile::ReadBlocks(const std::string &fileName, BlockList &blockList)
+{
+    std::ifstream inputFile(fileName, std::ios::binary);
+    FileHeader fileHeader;
+
+    if (!inputFile || !inputFile.read(reinterpret_cast<char *>(&fileHeader), sizeof(FileHeader)) ||
+        (0 != std::memcmp(fileHeader.m_magic, m_magicNumber, sizeof(m_magicNumber))) || (m_formatVersion != fileHeader.m_version))
+    {
+        std::cout << "CompressedEventFile::ReadBlocks - invalid compressed event file " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    std::uint64_t offset(sizeof(FileHeader)), outputOffset(0);
+
+    for (std::uint64_t iBlock = 0; iBlock < fileHeader.m_nBlocks; ++iBlock)
+    {
+        BlockHeader blockHeader;
+
+        if (!inputFile.seekg(offset) || !inputFile.read(reinterpret_cast<char *>(&blockHeader), sizeof(BlockHeader)))
+        {
+            std::cout << "CompressedEventFile::ReadBlocks - truncated compressed event file " << fileName << std::endl;
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+        }
+
+        offset += sizeof(BlockHeader);
+        blockList.push_back(Block{offset, blockHeader.m_compressedSize, outputOffset, blockHeader.m_uncompressedSize, 0 != blockHeader.m_isEventContainer});
+        offset += blockHeader.m_compressedSize;
+        outputOffset += blockHeader.m_uncompressedSize;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void CompressedEventFile::Decompress(const std::string &inputFileName, const BlockList &blockList, const std::string &outputFileName,
+    const unsigned int nThreads)
+{
+    const std::string temporaryFileName(outputFileName + "." + std::to_string(getpid()));
+    const int inputFd(open(inputFileName.c_str(), O_RDONLY));
+    const int outputFd(open(temporaryFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+    const std::uint64_t outputSize(blockList.empty() ? 0 : blockList.back().m_outputOffset + blockList.back().m_outputSize);
+
+    std::atomic<std::size_t> nextBlock(0);
+    std::atomic<bool> success((inputFd >= 0) && (outputFd >= 0) && (0 == ftruncate(outputFd, outputSize)));
+
+    if (success)
+    {
+        std::vector<std::thread> threads;
+
+        for (unsigned int iThread = 1; iThread < std::max(1U, nThreads); ++iThread)
+            threads.emplace_back(DecompressBlocks, inputFd, std::cref(blockList), outputFd, std::ref(nextBlock), std::ref(success));
+
+        CompressedEventFile::DecompressBlocks(inputFd, blockList, outputFd, nextBlock, success);
+
+        for (std::thread &thread : threads)
+            thread.join();
+    }
+
+    if (inputFd >= 0)
+        close(inputFd);
+
+    if ((outputFd >= 0) && (0 != close(outputFd)))
+        success = false;
+
+    if (!success || (0 != std::rename(temporaryFileName.c_str(), outputFileName.c_str())))
+    {
+        std::cout << "CompressedEventFile::Decompress - unable to decompress " << inputFileName << " to " << outputFileName << std::endl;
+        std::remove(temporaryFileName.c_str());
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef LAR_RECO_ZSTD
+void CompressedEventFile::DecompressBlocks(const int inputFd, const BlockList &blockList, const int outputFd, std::atomic<std::size_t> &nextBlock,
+    std::atomic<bool> &success)
+{
+    std::vector<char> inputBuffer, outputBuffer;
+
+    for (std::size_t iBlock = nextBlock++; success && (iBlock < blockList.size()); iBlock = nextBlock++)
+    {
+        const Block &block(blockList.at(iBlock));
+        inputBuffer.resize(block.m_compressedSize);
+        outputBuffer.resize(block.m_outputSize);
+
+        if ((static_cast<ssize_t>(inputBuffer.size()) != pread(inputFd, inputBuffer.data(), inputBuffer.size(), block.m_offset)) ||
+            (outputBuffer.size() != ZSTD_decompress(outputBuffer.data(), outputBuffer.size(), inputBuffer.data(), inputBuffer.size())) ||
+            (static_cast<ssize_t>(outputBuffer.size()) != pwrite(outputFd, outputBuffer.data(), outputBuffer.size(), block.m_outputOffset)))
+        {
+            success = false;
+        }
+    }
+}
+#else
+void CompressedEventFile::DecompressBlocks(const int, const BlockList &, const int, std::atomic<std::size_t> &, std::atomic<bool> &success)
+{
+    std::cout << "CompressedEventFile::Decompress - LArReco was built without zstd support (LAR_RECO_ZSTD)" << std::endl;
+    success = false;
+}
+#endif
+
+} // namespace lar_reco
@@ -0,0 +1,158 @@
+/**
+ *  @file   LArReco/src/EventDecompressor.cxx
+ *
+ *  @brief  Implementation of the event decompressor class.
+ *
+ *  $Log: $
+ */
+
+#include "Helpers/XmlHelper.h"
+
+#include "EventDecompressor.h"
+#include "EventFileHelper.h"
+
+#include <iostream>
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+EventDecompressor::EventDecompressor(const std::string &eventFileNameList, const std::string &outputDirectory, const unsigned int nThreads) :
+    m_nThreads(nThreads),
+    m_nFilesReady(0),
+    m_isFailed(false),
+    m_shouldStop(false)
+{
+    StringVector eventFileNames;
+    XmlHelper::TokenizeString(eventFileNameList, eventFileNames, ":");
+
+    for (const std::string &eventFileName : eventFileNames)
+    {
+        EventFile eventFile;
+        eventFile.m_inputFileName = eventFileName;
+        eventFile.m_outputFileName = eventFileName;
+
+        if (CompressedEventFile::IsCompressedFile(eventFileName))
+        {
+            // ATTN Each output name is qualified by its position in the list, in case different directories hold files of the same name
+            eventFile.m_outputFileName = outputDirectory + "/" + std::to_string(m_eventFileList.size()) + "." + CompressedEventFile::GetBinaryBaseName(eventFileName);
+            CompressedEventFile::ReadBlocks(eventFileName, eventFile.m_blockList);
+        }
+
+        m_eventFileNameList += (m_eventFileNameList.empty() ? "" : ":") + eventFile.m_outputFileName;
+        m_eventFileList.push_back(eventFile);
+    }
+
+    m_thread = std::thread(&EventDecompressor::Run, this);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventDecompressor::~EventDecompressor()
+{
+    this->Stop();
+    m_thread.join();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventDecompressor::HasCompressedFiles(const std::string &eventFileNameList)
+{
+    StringVector eventFileNames;
+    XmlHelper::TokenizeString(eventFileNameList, eventFileNames, ":");
+
+    for (const std::string &eventFileName : eventFileNames)
+    {
+        if (CompressedEventFile::IsCompressedFile(eventFileName))
+            return true;
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const std::string &EventDecompressor::GetEventFileNameList() const
+{
+    return m_eventFileNameList;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventDecompressor::WaitForFile(const unsigned int fileIndex)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this, fileIndex] { return (m_nFilesReady > fileIndex) || m_isFailed || m_shouldStop; });
+
+    return (m_nFilesReady > fileIndex);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventDecompressor::WaitForAll()
+{
+    return (m_eventFileList.empty() || this->WaitForFile(m_eventFileList.size() - 1));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventDecompressor::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shouldStop = true;
+    }
+
+    m_condition.notify_all();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventDecompressor::Run()
+{
+    for (const EventFile &eventFile : m_eventFileList)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_shouldStop)
+                return;
+        }
+
+        bool isReady(true);
+
+        if (eventFile.m_outputFileName != eventFile.m_inputFileName)
+        {
+            try
+            {
+                CompressedEventFile::Decompress(eventFile.m_inputFileName, eventFile.m_blockList, eventFile.m_outputFileName, m_nThreads);
+                EventFileHelper::WriteIndex(eventFile.m_outputFileName);
+            }
+            catch (const StatusCodeException &)
+            {
+                isReady = false;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (isReady)
+            {
+                ++m_nFilesReady;
+            }
+            else
+            {
+                m_isFailed = true;
+            }
+        }
+
+        m_condition.notify_all();
+
+        if (!isReady)
+            return;
+    }
+}
+
+} // namespace lar_reco
@@ -0,0 +1,400 @@
+/**
+ *  @file   LArReco/src/EventFileHelper.cxx
+ *
+ *  @brief  Implementation of the event file helper class.
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/StatusCodes.h"
+#include "Persistency/PandoraIO.h"
+
+#include "EventFileHelper.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+const char EventFileHelper::m_indexMagicNumber[8] = {'L', 'A', 'R', 'I', 'D', 'X', '\n', '\0'};
+const std::uint32_t EventFileHelper::m_indexFormatVersion = 1;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventFileHelper::IsBinaryFile(const std::string &fileName)
+{
+    const std::string binaryExtension(".pndr");
+
+    return ((fileName.size() > binaryExtension.size()) &&
+        (0 == fileName.compare(fileName.size() - binaryExtension.size(), binaryExtension.size(), binaryExtension)));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventFileHelper::GetEventContainers(const std::string &fileName, ContainerList &containerList)
+{
+    if (!ReadIndex(fileName, containerList))
+        ScanEventContainers(fileName, containerList);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventFileHelper::ScanEventContainers(const std::string &fileName, ContainerList &containerList)
+{
+    const int fd(open(fileName.c_str(), O_RDONLY));
+    struct stat fileStat;
+
+    if ((fd < 0) || (0 != fstat(fd, &fileStat)))
+    {
+        if (fd >= 0)
+            close(fd);
+
+        std::cout << "EventFileHelper::ScanEventContainers - unable to open " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+    }
+
+    const std::uint64_t fileSize(fileStat.st_size);
+    std::uint64_t offset(0);
+
+    while (offset + GetContainerHeaderSize() <= fileSize)
+    {
+        bool isEventContainer(false);
+        std::uint64_t containerSize(0);
+
+        if (!ReadContainerHeader(fd, offset, isEventContainer, containerSize) || (offset + containerSize > fileSize))
+        {
+            close(fd);
+            std::cout << "EventFileHelper::ScanEventContainers - invalid container at byte " << offset << " in " << fileName << std::endl;
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+        }
+
+        if (isEventContainer)
+            containerList.push_back(Container{offset, containerSize});
+
+        offset += containerSize;
+    }
+
+    close(fd);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string EventFileHelper::GetIndexFileName(const std::string &fileName)
+{
+    return fileName + ".idx";
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventFileHelper::ReadIndex(const std::string &fileName, ContainerList &containerList)
+{
+    std::uint64_t fileSize(0), indexFileSize(0);
+    std::int64_t modificationTime(0), indexModificationTime(0);
+
+    if (!GetFileStatus(fileName, fileSize, modificationTime) || !GetFileStatus(GetIndexFileName(fileName), indexFileSize, indexModificationTime))
+        return false;
+
+    std::ifstream indexFile(GetIndexFileName(fileName), std::ios::binary);
+    IndexHeader indexHeader;
+
+    if (!indexFile || !indexFile.read(reinterpret_cast<char *>(&indexHeader), sizeof(IndexHeader)))
+        return false;
+
+    // ATTN A stale index (e.g. the event file has since been rewritten) is ignored, rather than trusted
+    if ((0 != std::memcmp(indexHeader.m_magic, m_indexMagicNumber, sizeof(m_indexMagicNumber))) || (m_indexFormatVersion != indexHeader.m_version) ||
+        (fileSize != indexHeader.m_fileSize) || (modificationTime != indexHeader.m_modificationTime))
+    {
+        return false;
+    }
+
+    // ATTN The event count is only trusted as far as the index file can hold it, so a corrupt count cannot request a huge allocation
+    if ((indexFileSize < sizeof(IndexHeader)) || (indexHeader.m_nEvents > (indexFileSize - sizeof(IndexHeader)) / sizeof(Container)))
+        return false;
+
+    ContainerList indexContainerList(indexHeader.m_nEvents);
+
+    if (!indexFile.read(reinterpret_cast<char *>(indexContainerList.data()), indexContainerList.size() * sizeof(Container)))
+        return false;
+
+    for (const Container &container : indexContainerList)
+    {
+        if ((container.m_offset > fileSize) || (container.m_size > fileSize - container.m_offset))
+            return false;
+    }
+
+    containerList.insert(containerList.end(), indexContainerList.begin(), indexContainerList.end());
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int EventFileHelper::WriteIndex(const std::string &fileName)
+{
+    ContainerList containerList;
+    ScanEventContainers(fileName, containerList);
+    WriteIndex(fileName, containerList);
+
+    return containerList.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventFileHelper::WriteEventSelection(const std::string &fileName, const EventIndexList &eventIndexList, const std::string &outputFileName)
+{
+    ContainerList containerList;
+    GetEventContainers(fileName, containerList);
+
+    for (const unsigned int eventIndex : eventIndexList)
+    {
+        if (eventIndex >= containerList.size())
+        {
+            std::cout << "EventFileHelper::WriteEventSelection - event " << eventIndex << " requested, but " << fileName << " contains "
+                      << containerList.size() << " events" << std::endl;
+            throw StatusCodeException(STATUS_CODE_OUT_OF_RANGE);
+        }
+    }
+
+    const int inputFd(open(fileName.c_str(), O_RDONLY));
+    const int outputFd(open(outputFileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644));
+
+    // ATTN Containers are self-describing, so any header-preceding content (e.g. a geometry container) is copied verbatim
+    const std::uint64_t prologueSize(containerList.empty() ? 0 : containerList.front().m_offset);
+    bool success((inputFd >= 0) && (outputFd >= 0) && CopyRange(inputFd, 0, prologueSize, outputFd));
+
+    ContainerList outputContainerList;
+    std::uint64_t outputOffset(prologueSize);
+
+    for (const unsigned int eventIndex : eventIndexList)
+    {
+        const Container &container(containerList.at(eventIndex));
+        success = success && CopyRange(inputFd, container.m_offset, container.m_size, outputFd);
+        outputContainerList.push_back(Container{outputOffset, container.m_size});
+        outputOffset += container.m_size;
+    }
+
+    if (inputFd >= 0)
+        close(inputFd);
+
+    if ((outputFd >= 0) && (0 != close(outputFd)))
+        success = false;
+
+    if (!success)
+    {
+        std::cout << "EventFileHelper::WriteEventSelection - unable to copy events from " << fileName << " to " << outputFileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    WriteIndex(outputFileName, outputContainerList);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventFileHelper::UpdateCompleteEvents(const std::string &fileName, unsigned int &nCompleteEvents, std::uint64_t &endOffset)
+{
+    (void)EventFileHelper::FindEventsEnd(fileName, std::numeric_limits<unsigned int>::max(), nCompleteEvents, endOffset);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventFileHelper::TruncateEvents(const std::string &fileName, const unsigned int nEvents)
+{
+    unsigned int nCompleteEvents(0);
+    std::uint64_t endOffset(0);
+
+    if (!EventFileHelper::FindEventsEnd(fileName, nEvents, nCompleteEvents, endOffset))
+        return (0 == nEvents);
+
+    if (nCompleteEvents < nEvents)
+    {
+        std::cout << "EventFileHelper::TruncateEvents - " << fileName << " holds " << nCompleteEvents << " complete events, expected " << nEvents
+                  << std::endl;
+        return false;
+    }
+
+    if (0 != truncate(fileName.c_str(), endOffset))
+    {
+        std::cout << "EventFileHelper::TruncateEvents - unable to truncate " << fileName << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventFileHelper::ReadContainerHeader(const int fd, const std::uint64_t offset, bool &isEventContainer, std::uint64_t &containerSize)
+{
+    // ATTN Mirrors pandora::BinaryFileWriter::WriteHeader: the file hash, the container id, then the container size as a stream position
+    char header[sizeof(unsigned int) + sizeof(ContainerId) + sizeof(std::ifstream::pos_type)];
+
+    if (static_cast<ssize_t>(sizeof(header)) != pread(fd, header, sizeof(header), offset))
+        return false;
+
+    unsigned int fileHash(0);
+    ContainerId containerId(UNKNOWN_CONTAINER);
+    std::ifstream::pos_type containerPosition;
+    std::memcpy(&fileHash, header, sizeof(unsigned int));
+    std::memcpy(&containerId, header + sizeof(unsigned int), sizeof(ContainerId));
+    std::memcpy(static_cast<void *>(&containerPosition), header + sizeof(unsigned int) + sizeof(ContainerId), sizeof(std::ifstream::pos_type));
+
+    const std::streamoff size(containerPosition);
+
+    if ((PANDORA_FILE_HASH != fileHash) || (size < static_cast<std::streamoff>(sizeof(header))))
+        return false;
+
+    isEventContainer = (EVENT_CONTAINER == containerId);
+    containerSize = size;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::size_t EventFileHelper::GetContainerHeaderSize()
+{
+    return sizeof(unsigned int) + sizeof(ContainerId) + sizeof(std::ifstream::pos_type);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventFileHelper::GetFileStatus(const std::string &fileName, std::uint64_t &fileSize, std::int64_t &modificationTime)
+{
+    struct stat fileStat;
+
+    if (0 != stat(fileName.c_str(), &fileStat))
+        return false;
+
+    fileSize = fileStat.st_size;
+    modificationTime = fileStat.st_mtime;
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventFileHelper::FindEventsEnd(const std::string &fileName, const unsigned int maxEvents, unsigned int &nCompleteEvents, std::uint64_t &endOffset)
+{
+    const int fd(open(fileName.c_str(), O_RDONLY));
+    struct stat fileStat;
+
+    if ((fd < 0) || (0 != fstat(fd, &fileStat)))
+    {
+        if (fd >= 0)
+            close(fd);
+
+        return false;
+    }
+
+    const std::uint64_t fileSize(fileStat.st_size);
+    std::uint64_t offset(endOffset);
+
+    while (offset + GetContainerHeaderSize() <= fileSize)
+    {
+        bool isEventContainer(false);
+        std::uint64_t containerSize(0);
+
+        // ATTN A writer fills in the container size once the container is complete, so an interrupted container fails these checks
+        if (!ReadContainerHeader(fd, offset, isEventContainer, containerSize) || (0 == containerSize) || (offset + containerSize > fileSize))
+            break;
+
+        if (isEventContainer && (nCompleteEvents == maxEvents))
+            break;
+
+        offset += containerSize;
+
+        if (isEventContainer)
+            ++nCompleteEvents;
+
+        // ATTN Containers following the last event container of interest are not kept
+        if (isEventContainer || (0 == nCompleteEvents))
+            endOffset = offset;
+    }
+
+    close(fd);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventFileHelper::WriteIndex(const std::string &fileName, const ContainerList &containerList)
+{
+    static_assert(16 == sizeof(Container), "EventFileHelper: unexpected index record size");
+
+    IndexHeader indexHeader;
+    std::memset(&indexHeader, 0, sizeof(IndexHeader));
+    std::memcpy(indexHeader.m_magic, m_indexMagicNumber, sizeof(m_indexMagicNumber));
+    indexHeader.m_version = m_indexFormatVersion;
+    indexHeader.m_nEvents = containerList.size();
+
+    if (!GetFileStatus(fileName, indexHeader.m_fileSize, indexHeader.m_modificationTime))
+    {
+        std::cout << "EventFileHelper::WriteIndex - unable to inspect " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+    }
+
+    // ATTN Written alongside, then renamed into place, so that concurrent readers never see a partial index
+    const std::string indexFileName(GetIndexFileName(fileName));
+    const std::string temporaryFileName(indexFileName + "." + std::to_string(getpid()));
+
+    {
+        std::ofstream indexFile(temporaryFileName, std::ios::binary);
+        indexFile.write(reinterpret_cast<const char *>(&indexHeader), sizeof(IndexHeader));
+        indexFile.write(reinterpret_cast<const char *>(containerList.data()), containerList.size() * sizeof(Container));
+
+        if (!indexFile.flush())
+        {
+            std::cout << "EventFileHelper::WriteIndex - unable to write " << temporaryFileName << std::endl;
+            std::remove(temporaryFileName.c_str());
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+        }
+    }
+
+    if (0 != std::rename(temporaryFileName.c_str(), indexFileName.c_str()))
+    {
+        std::cout << "EventFileHelper::WriteIndex - unable to create " << indexFileName << std::endl;
+        std::remove(temporaryFileName.c_str());
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventFileHelper::CopyRange(const int inputFd, const std::uint64_t offset, const std::uint64_t size, const int outputFd)
+{
+    std::vector<char> buffer(std::min(size, static_cast<std::uint64_t>(1 << 20)));
+
+    for (std::uint64_t position = offset; position < offset + size;)
+    {
+        const ssize_t nBytesRead(pread(inputFd, buffer.data(), std::min(static_cast<std::uint64_t>(buffer.size()), offset + size - position), position));
+
+        if (nBytesRead <= 0)
+            return false;
+
+        for (ssize_t nBytesWritten = 0; nBytesWritten < nBytesRead;)
+        {
+            const ssize_t nBytes(write(outputFd, buffer.data() + nBytesWritten, nBytesRead - nBytesWritten));
+
+            if (nBytes <= 0)
+                return false;
+
+            nBytesWritten += nBytes;
+        }
+
+        position += nBytesRead;
+    }
+
+    return true;
+}
+
+} // namespace lar_reco
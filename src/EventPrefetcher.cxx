@@ -0,0 +1,184 @@
+/**
+ *  @file   LArReco/src/EventPrefetcher.cxx
+ *
+ *  @brief  Implementation of the event prefetcher class.
+ *
+ *  $Log: $
+ */
+
+#include "Helpers/XmlHelper.h"
+
+#include "EventDecompressor.h"
+#include "EventFileHelper.h"
+#include "EventPrefetcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+#include <vector>
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+EventPrefetcher::EventPrefetcher(const std::string &eventFileNameList, const int nEventsToSkip, const unsigned int lookaheadDepth,
+        EventDecompressor *const pEventDecompressor) :
+    m_eventFileNameList(eventFileNameList),
+    m_nEventsToSkip(nEventsToSkip),
+    m_lookaheadDepth(std::max(1U, lookaheadDepth)),
+    m_pEventDecompressor(pEventDecompressor),
+    m_nEventsPrefetched(0),
+    m_nEventsConsumed(0),
+    m_bytesPrefetched(0),
+    m_isFinished(false),
+    m_shouldStop(false),
+    m_thread(&EventPrefetcher::Run, this)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventPrefetcher::~EventPrefetcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shouldStop = true;
+    }
+
+    m_condition.notify_all();
+
+    if (m_pEventDecompressor)
+        m_pEventDecompressor->Stop();
+
+    m_thread.join();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double EventPrefetcher::WaitForNextEvent()
+{
+    const auto startTime(std::chrono::steady_clock::now());
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [this] { return (m_nEventsPrefetched > m_nEventsConsumed) || m_isFinished; });
+    ++m_nEventsConsumed;
+    lock.unlock();
+
+    m_condition.notify_all();
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::uint64_t EventPrefetcher::GetBytesPrefetched() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytesPrefetched;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventPrefetcher::Run()
+{
+    try
+    {
+        StringVector eventFileNames;
+        XmlHelper::TokenizeString(m_eventFileNameList, eventFileNames, ":");
+
+        for (unsigned int iFile = 0; iFile < eventFileNames.size(); ++iFile)
+        {
+            const std::string &eventFileName(eventFileNames.at(iFile));
+
+            if (m_pEventDecompressor && !m_pEventDecompressor->WaitForFile(iFile))
+                break;
+
+            // ATTN Other formats are decoded as they are read, so are left to LArEventReading
+            if (!EventFileHelper::IsBinaryFile(eventFileName))
+                continue;
+
+            if (!this->PrefetchFile(eventFileName, (0 == iFile) ? std::max(0, m_nEventsToSkip) : 0))
+                return;
+        }
+    }
+    catch (...)
+    {
+        // ATTN Prefetching is an optimisation only, so any problem is left for LArEventReading to report
+        std::cout << "EventPrefetcher, prefetching abandoned for " << m_eventFileNameList << std::endl;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isFinished = true;
+    }
+
+    m_condition.notify_all();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventPrefetcher::PrefetchFile(const std::string &eventFileName, const unsigned int nEventsToSkip)
+{
+    EventFileHelper::ContainerList containerList;
+    EventFileHelper::GetEventContainers(eventFileName, containerList);
+
+    const int fd(open(eventFileName.c_str(), O_RDONLY));
+
+    if (fd < 0)
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+
+    bool shouldStop(false);
+
+    for (unsigned int iContainer = std::min(static_cast<std::size_t>(nEventsToSkip), containerList.size()); iContainer < containerList.size(); ++iContainer)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_shouldStop || (m_nEventsPrefetched < m_nEventsConsumed + m_lookaheadDepth); });
+            shouldStop = m_shouldStop;
+        }
+
+        if (shouldStop)
+            break;
+
+        const EventFileHelper::Container &container(containerList.at(iContainer));
+
+        this->ReadRange(fd, container.m_offset, container.m_size);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_nEventsPrefetched;
+            m_bytesPrefetched += container.m_size;
+        }
+
+        m_condition.notify_all();
+    }
+
+    close(fd);
+
+    return !shouldStop;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventPrefetcher::ReadRange(const int fd, const std::uint64_t offset, const std::uint64_t size) const
+{
+    // ATTN The hint alone may be ignored, e.g. by network filesystems, so the range is also read explicitly
+    (void)posix_fadvise(fd, offset, size, POSIX_FADV_WILLNEED);
+
+    std::vector<char> buffer(std::min(size, static_cast<std::uint64_t>(1 << 20)));
+
+    for (std::uint64_t position = offset; position < offset + size;)
+    {
+        const ssize_t nBytes(pread(fd, buffer.data(), std::min(static_cast<std::uint64_t>(buffer.size()), offset + size - position), position));
+
+        if (nBytes <= 0)
+            break;
+
+        position += nBytes;
+    }
+}
+
+} // namespace lar_reco
@@ -0,0 +1,212 @@
+/**
+ *  @file   LArReco/src/EventStatistics.cxx
+ *
+ *  @brief  Implementation of the event statistics class.
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/StatusCodes.h"
+
+#include "EventStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+EventStatistics::EventStatistics() :
+    m_canResetPeakMemory(static_cast<bool>(std::ofstream("/proc/self/clear_refs")))
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventStatistics::StartEvent() const
+{
+    // ATTN Writing 5 to clear_refs resets the VmHWM value reported in /proc/self/status to the current resident memory
+    if (m_canResetPeakMemory)
+        std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventStatistics::AddEvent(const EventRecord &eventRecord)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_eventRecordList.push_back(eventRecord);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int EventStatistics::GetNumberOfEvents() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_eventRecordList.size();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventStatistics::DisplaySummary(const double wallTime) const
+{
+    const EventRecordList eventRecordList(this->GetSortedEventRecords());
+
+    if (eventRecordList.empty())
+        return;
+
+    std::vector<double> sortedTimes;
+    EventRecordList skippedEvents;
+    double totalResetTime(0.), totalInputStallTime(0.), filteredProcessTime(0.);
+    long peakResidentMemory(-1), totalAllocations(0), filterInputHits(-1), filterRemovedHits(-1);
+
+    for (const EventRecord &eventRecord : eventRecordList)
+    {
+        sortedTimes.push_back(eventRecord.GetTotalTime());
+        totalResetTime += eventRecord.m_resetTime;
+        totalInputStallTime += eventRecord.m_inputStallTime;
+        peakResidentMemory = std::max(peakResidentMemory, eventRecord.m_peakResidentMemory);
+        totalAllocations += eventRecord.m_nAllocations;
+
+        if (eventRecord.m_nFilterInputHits >= 0)
+        {
+            filterInputHits = std::max(0L, filterInputHits) + eventRecord.m_nFilterInputHits;
+            filterRemovedHits = std::max(0L, filterRemovedHits) + eventRecord.m_nFilterRemovedHits;
+            filteredProcessTime += eventRecord.m_processTime;
+        }
+
+        if (!eventRecord.m_skipReason.empty())
+            skippedEvents.push_back(eventRecord);
+    }
+
+    std::sort(sortedTimes.begin(), sortedTimes.end());
+
+    EventRecordList slowestEvents(eventRecordList);
+    const unsigned int nSlowestEvents(std::min(static_cast<std::size_t>(5), slowestEvents.size()));
+    std::partial_sort(slowestEvents.begin(), slowestEvents.begin() + nSlowestEvents, slowestEvents.end(),
+        [](const EventRecord &lhs, const EventRecord &rhs) { return lhs.GetTotalTime() > rhs.GetTotalTime(); });
+
+    std::ostringstream summary;
+    summary << std::endl << "LArReco, event statistics summary" << std::endl << std::fixed << std::setprecision(3)
+            << "    Events: " << eventRecordList.size() << ", " << wallTime << " s, "
+            << ((wallTime > 0.) ? eventRecordList.size() / wallTime : 0.) << " events/s" << std::endl
+            << "    Latency (s): p50 " << GetPercentile(sortedTimes, 50.) << ", p95 " << GetPercentile(sortedTimes, 95.) << ", p99 "
+            << GetPercentile(sortedTimes, 99.) << ", max " << sortedTimes.back() << " (of which reset " << totalResetTime << " in total)" << std::endl
+            << "    Input stall time: " << totalInputStallTime << " s in total" << std::endl
+            << "    Allocations per event: " << totalAllocations / static_cast<long>(eventRecordList.size()) << std::endl
+            << "    Peak resident memory: " << ((peakResidentMemory < 0) ? std::string("unavailable") : std::to_string(peakResidentMemory) + " kB")
+            << std::endl;
+
+    // ATTN The saving is not measured: it is estimated by assuming that the processing time of the filtered events scales with the number of
+    // hits they keep, which ignores any fixed cost per event and any cost that grows faster than linearly with the number of hits
+    if (filterInputHits >= 0)
+    {
+        const long filterKeptHits(filterInputHits - filterRemovedHits);
+        summary << "    Hits removed by filter: " << filterRemovedHits << " of " << filterInputHits << " ("
+                << ((filterInputHits > 0) ? 100. * filterRemovedHits / filterInputHits : 0.) << "%), time saved (estimate, assuming time scales"
+                << " with hits kept) " << ((filterKeptHits > 0) ? filteredProcessTime * filterRemovedHits / filterKeptHits : 0.) << " s" << std::endl;
+    }
+
+    summary << "    Skipped events: " << skippedEvents.size() << std::endl;
+
+    for (const EventRecord &eventRecord : skippedEvents)
+    {
+        summary << "        " << eventRecord.GetTotalTime() << " s, event " << eventRecord.m_eventNumber << ", file "
+                << eventRecord.m_eventFileName << ", " << eventRecord.m_skipReason << std::endl;
+    }
+
+    summary << "    Slowest events:" << std::endl;
+
+    for (unsigned int iEvent = 0; iEvent < nSlowestEvents; ++iEvent)
+    {
+        const EventRecord &eventRecord(slowestEvents.at(iEvent));
+        summary << "        " << eventRecord.GetTotalTime() << " s, event " << eventRecord.m_eventNumber << ", file "
+                << eventRecord.m_eventFileName << std::endl;
+    }
+
+    std::cout << summary.str() << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventStatistics::WriteEventLog(const std::string &fileName) const
+{
+    std::ofstream outputFile(fileName);
+
+    if (!outputFile)
+    {
+        std::cout << "EventStatistics, unable to open output file " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    outputFile << std::setprecision(9) << "File,Event,InputStallTime,ProcessTime,ResetTime,PeakResidentMemory,Allocations,"
+               << "FilterInputHits,FilterRemovedHits,SkipReason,StagePeakResidentMemory" << std::endl;
+
+    for (const EventRecord &eventRecord : this->GetSortedEventRecords())
+    {
+        outputFile << eventRecord.m_eventFileName << "," << eventRecord.m_eventNumber << "," << eventRecord.m_inputStallTime << ","
+                   << eventRecord.m_processTime << "," << eventRecord.m_resetTime << "," << eventRecord.m_peakResidentMemory << ","
+                   << eventRecord.m_nAllocations << "," << eventRecord.m_nFilterInputHits << "," << eventRecord.m_nFilterRemovedHits << ","
+                   << (eventRecord.m_skipReason.empty() ? std::string("none") : eventRecord.m_skipReason) << ",";
+
+        // ATTN Stage peaks are written as a single column, e.g. AllHitsCosmicReco=701000;LArMaster=734000;LArPreProcessing=512000;
+        // SliceReco=734000;Slicing=698000, never left empty
+        if (eventRecord.m_stagePeakResidentMemory.empty())
+            outputFile << "none";
+
+        for (auto iter = eventRecord.m_stagePeakResidentMemory.begin(); iter != eventRecord.m_stagePeakResidentMemory.end(); ++iter)
+            outputFile << ((iter != eventRecord.m_stagePeakResidentMemory.begin()) ? ";" : "") << iter->first << "=" << iter->second;
+
+        outputFile << std::endl;
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+long EventStatistics::GetPeakResidentMemory()
+{
+    std::ifstream statusFile("/proc/self/status");
+    std::string line;
+
+    while (std::getline(statusFile, line))
+    {
+        if (0 == line.compare(0, 6, "VmHWM:"))
+            return std::atol(line.c_str() + 6);
+    }
+
+    return -1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventStatistics::EventRecordList EventStatistics::GetSortedEventRecords() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    EventRecordList eventRecordList(m_eventRecordList);
+
+    std::stable_sort(eventRecordList.begin(), eventRecordList.end(),
+        [](const EventRecord &lhs, const EventRecord &rhs) { return (lhs.m_threadIndex < rhs.m_threadIndex); });
+
+    return eventRecordList;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+double EventStatistics::GetPercentile(const std::vector<double> &sortedTimes, const double percentile)
+{
+    if (sortedTimes.empty())
+        return 0.;
+
+    const std::size_t rank(static_cast<std::size_t>(std::ceil(percentile / 100. * sortedTimes.size())));
+
+    return sortedTimes.at(std::min(sortedTimes.size(), std::max(static_cast<std::size_t>(1), rank)) - 1);
+}
+
+} // namespace lar_reco
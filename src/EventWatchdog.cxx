@@ -0,0 +1,332 @@
+/**
+ *  @file   LArReco/src/EventWatchdog.cxx
+ *
+ *  @brief  Implementation of the event watchdog class.
+ *
+ *  $Log: $
+ */
+
+#include "EventWatchdog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+/**
+ *  @brief  EventTiming class, describing the timing of the event in progress on the current thread
+ */
+class EventTiming
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    EventTiming();
+
+    std::chrono::steady_clock::time_point   m_startTime;            ///< The start time of the event
+    std::chrono::steady_clock::time_point   m_deadline;             ///< The time after which the event is abandoned
+    double                                  m_overTimeElapsed;      ///< The elapsed time when the limit was found to be exceeded, units s (or -1)
+    std::string                             m_overTimeAlgorithm;    ///< The algorithm after which the limit was found to be exceeded
+};
+
+/**
+ *  @brief  ThreadActivity class, describing the event in progress on a thread, as seen by the backstop thread
+ */
+class ThreadActivity
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    ThreadActivity();
+
+    std::mutex                              m_mutex;                ///< The mutex protecting the activity from the backstop thread
+    bool                                    m_isInEvent;            ///< Whether the thread is processing an event
+    std::chrono::steady_clock::time_point   m_startTime;            ///< The start time of the event
+    std::string                             m_lastAlgorithm;        ///< The last wrapped algorithm completed in the event (empty if none)
+};
+
+typedef std::vector<std::shared_ptr<ThreadActivity>> ThreadActivityList;
+
+/**
+ *  @brief  Backstop class, running the thread that ends the job once the event on any thread exceeds the hard time limit
+ */
+class Backstop
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    Backstop();
+
+    /**
+     *  @brief  Destructor, stopping the backstop thread
+     */
+    ~Backstop();
+
+    /**
+     *  @brief  Start the backstop thread
+     *
+     *  @param  hardTimeLimit the hard time limit, units s
+     */
+    void Start(const double hardTimeLimit);
+
+    /**
+     *  @brief  Whether the backstop thread is running
+     *
+     *  @return boolean
+     */
+    bool IsRunning() const;
+
+    /**
+     *  @brief  Register the activity of a new thread with the backstop
+     *
+     *  @return the address of the activity
+     */
+    std::shared_ptr<ThreadActivity> Register();
+
+private:
+    /**
+     *  @brief  Check the registered activities periodically, until stopped
+     */
+    void Run();
+
+    std::mutex                  m_mutex;                ///< The mutex protecting the activity list and stop flag
+    std::condition_variable     m_condition;            ///< The condition signalled when the backstop should stop
+    std::thread                 m_thread;               ///< The backstop thread
+    bool                        m_shouldStop;           ///< Whether the backstop thread should stop
+    double                      m_hardTimeLimit;        ///< The hard wall time limit for each event, units s
+    ThreadActivityList          m_threadActivityList;   ///< The activities of the threads that have processed events
+};
+
+double g_timeLimit(0.);                                     ///< The wall time limit for each event, units s
+Backstop g_backstop;                                        ///< The backstop enforcing the hard wall time limit, if any
+thread_local EventTiming g_eventTiming;                     ///< The timing of the event in progress on the current thread
+thread_local std::shared_ptr<ThreadActivity> g_pThreadActivity; ///< The activity of the current thread, if registered with the backstop
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventTiming::EventTiming() :
+    m_overTimeElapsed(-1.)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+ThreadActivity::ThreadActivity() :
+    m_isInEvent(false)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+Backstop::Backstop() :
+    m_shouldStop(false),
+    m_hardTimeLimit(0.)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+Backstop::~Backstop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shouldStop = true;
+    }
+
+    m_condition.notify_all();
+    m_thread.join();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void Backstop::Start(const double hardTimeLimit)
+{
+    if (m_thread.joinable() || (hardTimeLimit <= 0.))
+        return;
+
+    m_hardTimeLimit = hardTimeLimit;
+    m_thread = std::thread(&Backstop::Run, this);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool Backstop::IsRunning() const
+{
+    return m_thread.joinable();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::shared_ptr<ThreadActivity> Backstop::Register()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_threadActivityList.push_back(std::make_shared<ThreadActivity>());
+
+    return m_threadActivityList.back();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void Backstop::Run()
+{
+    const auto checkInterval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(std::min(1., m_hardTimeLimit / 10.))));
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_condition.wait_for(lock, checkInterval, [this] { return m_shouldStop; }))
+    {
+        const auto now(std::chrono::steady_clock::now());
+
+        for (ThreadActivityList::iterator iter = m_threadActivityList.begin(); iter != m_threadActivityList.end();)
+        {
+            // ATTN The activity of an exited thread is held only by the list
+            if (1 == iter->use_count())
+            {
+                iter = m_threadActivityList.erase(iter);
+                continue;
+            }
+
+            ThreadActivity &threadActivity(**iter);
+            std::lock_guard<std::mutex> activityLock(threadActivity.m_mutex);
+            const double elapsed(std::chrono::duration<double>(now - threadActivity.m_startTime).count());
+
+            // ATTN The stuck thread cannot be stopped, so exit without running static destructors, which would wait on it (and on this thread)
+            if (threadActivity.m_isInEvent && (elapsed > m_hardTimeLimit))
+            {
+                std::cout << "EventWatchdog - an event has run for " << elapsed << " s, beyond the hard limit of " << m_hardTimeLimit << " s"
+                          << (threadActivity.m_lastAlgorithm.empty() ? std::string() : ", since algorithm " + threadActivity.m_lastAlgorithm)
+                          << ", ending the job" << std::endl;
+                std::_Exit(EXIT_FAILURE);
+            }
+
+            ++iter;
+        }
+    }
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+void EventWatchdog::SetTimeLimit(const double timeLimit)
+{
+    g_timeLimit = std::max(0., timeLimit);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventWatchdog::SetHardTimeLimit(const double hardTimeLimit)
+{
+    g_backstop.Start(hardTimeLimit);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventWatchdog::IsEnabled()
+{
+    return (g_timeLimit > 0.);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventWatchdog::BeginEvent()
+{
+    EventTiming &eventTiming(g_eventTiming);
+    eventTiming.m_startTime = std::chrono::steady_clock::now();
+    eventTiming.m_deadline = eventTiming.m_startTime +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(g_timeLimit));
+    eventTiming.m_overTimeElapsed = -1.;
+    eventTiming.m_overTimeAlgorithm.clear();
+
+    if (!g_backstop.IsRunning())
+        return;
+
+    if (!g_pThreadActivity)
+        g_pThreadActivity = g_backstop.Register();
+
+    std::lock_guard<std::mutex> lock(g_pThreadActivity->m_mutex);
+    g_pThreadActivity->m_isInEvent = true;
+    g_pThreadActivity->m_startTime = eventTiming.m_startTime;
+    g_pThreadActivity->m_lastAlgorithm.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventWatchdog::EndEvent()
+{
+    if (!g_pThreadActivity)
+        return;
+
+    std::lock_guard<std::mutex> lock(g_pThreadActivity->m_mutex);
+    g_pThreadActivity->m_isInEvent = false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventWatchdog::CheckTime(const std::string &algorithmType)
+{
+    EventTiming &eventTiming(g_eventTiming);
+
+    if (g_pThreadActivity)
+    {
+        std::lock_guard<std::mutex> lock(g_pThreadActivity->m_mutex);
+        g_pThreadActivity->m_lastAlgorithm = algorithmType;
+    }
+
+    if (!EventWatchdog::IsEnabled() || (eventTiming.m_overTimeElapsed >= 0.))
+        return (eventTiming.m_overTimeElapsed < 0.);
+
+    const auto now(std::chrono::steady_clock::now());
+
+    if (now <= eventTiming.m_deadline)
+        return true;
+
+    eventTiming.m_overTimeElapsed = std::chrono::duration<double>(now - eventTiming.m_startTime).count();
+    eventTiming.m_overTimeAlgorithm = algorithmType;
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool EventWatchdog::IsEventOverTime()
+{
+    return (g_eventTiming.m_overTimeElapsed >= 0.);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string EventWatchdog::GetOverTimeDescription()
+{
+    const EventTiming &eventTiming(g_eventTiming);
+
+    if (eventTiming.m_overTimeElapsed < 0.)
+        return std::string();
+
+    std::ostringstream description;
+    description << "wall time reached " << eventTiming.m_overTimeElapsed << " s (limit " << g_timeLimit << " s) after algorithm "
+                << eventTiming.m_overTimeAlgorithm;
+
+    return description.str();
+}
+
+} // namespace lar_reco
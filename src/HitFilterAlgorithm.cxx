@@ -0,0 +1,268 @@
+/**
+ *  @file   LArReco/src/HitFilterAlgorithm.cxx
+ *
+ *  @brief  Implementation of the hit filter algorithm class.
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/AlgorithmHeaders.h"
+
+#include "larpandoracontent/LArObjects/LArCaloHit.h"
+
+#include "HitFilterAlgorithm.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+using namespace pandora;
+
+namespace
+{
+
+thread_local long g_nEventInputHits(-1);        ///< The hits examined by any hit filter for the event on the current thread (or -1)
+thread_local long g_nEventRemovedHits(-1);      ///< The hits removed by any hit filter for the event on the current thread (or -1)
+thread_local bool g_isEventWithoutHits(false);  ///< Whether a hit filter found no hits in its regions of interest for the event on the current thread
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+HitFilterAlgorithm::HitFilterAlgorithm() :
+    m_minTime(-std::numeric_limits<float>::max()),
+    m_maxTime(std::numeric_limits<float>::max()),
+    m_minX(-std::numeric_limits<float>::max()),
+    m_maxX(std::numeric_limits<float>::max()),
+    m_minY(-std::numeric_limits<float>::max()),
+    m_maxY(std::numeric_limits<float>::max()),
+    m_minZ(-std::numeric_limits<float>::max()),
+    m_maxZ(std::numeric_limits<float>::max()),
+    m_shouldUseVolumeBounds(false),
+    m_volumeBoundsTolerance(0.f),
+    m_shouldRemoveGapHits(false),
+    m_gapTolerance(0.f),
+    m_shouldPrintCounts(false)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void HitFilterAlgorithm::BeginEvent()
+{
+    g_nEventInputHits = -1;
+    g_nEventRemovedHits = -1;
+    g_isEventWithoutHits = false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+long HitFilterAlgorithm::GetEventInputHits()
+{
+    return g_nEventInputHits;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+long HitFilterAlgorithm::GetEventRemovedHits()
+{
+    return g_nEventRemovedHits;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool HitFilterAlgorithm::IsEventWithoutHits()
+{
+    return g_isEventWithoutHits;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode HitFilterAlgorithm::Run()
+{
+    const CaloHitList *pCaloHitList(nullptr);
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::GetCurrentList(*this, pCaloHitList));
+
+    CaloHitList filteredCaloHitList;
+
+    for (const CaloHit *const pCaloHit : *pCaloHitList)
+    {
+        if (this->IsInRegionOfInterest(pCaloHit))
+            filteredCaloHitList.push_back(pCaloHit);
+    }
+
+    const long nInputHits(static_cast<long>(pCaloHitList->size()));
+    const long nRemovedHits(nInputHits - static_cast<long>(filteredCaloHitList.size()));
+    g_nEventInputHits = std::max(0L, g_nEventInputHits) + nInputHits;
+    g_nEventRemovedHits = std::max(0L, g_nEventRemovedHits) + nRemovedHits;
+
+    if (m_shouldPrintCounts)
+        std::cout << "HitFilterAlgorithm - removed " << nRemovedHits << " of " << nInputHits << " hits" << std::endl;
+
+    // ATTN Pandora does not save empty lists, so an event without hits in the regions of interest is abandoned, rather than reconstructed
+    // from all of its hits; the failure ends PandoraApi::ProcessEvent and the caller records the event as skipped
+    if (filteredCaloHitList.empty() && (nInputHits > 0))
+    {
+        g_isEventWithoutHits = true;
+        return STATUS_CODE_NOT_FOUND;
+    }
+
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::SaveList(*this, filteredCaloHitList, m_outputCaloHitListName));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraContentApi::ReplaceCurrentList<CaloHit>(*this, m_outputCaloHitListName));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool HitFilterAlgorithm::IsInRegionOfInterest(const CaloHit *const pCaloHit) const
+{
+    if ((pCaloHit->GetTime() < m_minTime) || (pCaloHit->GetTime() > m_maxTime))
+        return false;
+
+    if (!this->IsInBox(pCaloHit))
+        return false;
+
+    if (m_shouldRemoveGapHits && this->IsInDetectorGap(pCaloHit))
+        return false;
+
+    if (m_volumeIds.empty() && !m_shouldUseVolumeBounds)
+        return true;
+
+    const lar_content::LArCaloHit *const pLArCaloHit(dynamic_cast<const lar_content::LArCaloHit *>(pCaloHit));
+
+    // ATTN Without a volume id, a hit cannot be placed in a region of interest defined by volume
+    if (!pLArCaloHit)
+        return false;
+
+    const unsigned int volumeId(pLArCaloHit->GetLArTPCVolumeId());
+
+    if (!m_volumeIds.empty() && !m_volumeIds.count(volumeId))
+        return false;
+
+    if (!m_shouldUseVolumeBounds)
+        return true;
+
+    const LArTPCMap &larTPCMap(this->GetPandora().GetGeometry()->GetLArTPCMap());
+    const LArTPCMap::const_iterator iter(larTPCMap.find(volumeId));
+
+    if (larTPCMap.end() == iter)
+        return false;
+
+    const LArTPC *const pLArTPC(iter->second);
+    const CartesianVector &position(pCaloHit->GetPositionVector());
+
+    if (std::fabs(position.GetX() - pLArTPC->GetCenterX()) > 0.5f * pLArTPC->GetWidthX() + m_volumeBoundsTolerance)
+        return false;
+
+    // ATTN The U and V wire coordinates are rotated, so only the drift coordinate of their hits can be compared with the volume bounds
+    const HitType hitType(pCaloHit->GetHitType());
+
+    if (((TPC_VIEW_W == hitType) || (TPC_3D == hitType)) &&
+        (std::fabs(position.GetZ() - pLArTPC->GetCenterZ()) > 0.5f * pLArTPC->GetWidthZ() + m_volumeBoundsTolerance))
+    {
+        return false;
+    }
+
+    if ((TPC_3D == hitType) && (std::fabs(position.GetY() - pLArTPC->GetCenterY()) > 0.5f * pLArTPC->GetWidthY() + m_volumeBoundsTolerance))
+        return false;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool HitFilterAlgorithm::IsInBox(const CaloHit *const pCaloHit) const
+{
+    const CartesianVector &position(pCaloHit->GetPositionVector());
+
+    if ((position.GetX() < m_minX) || (position.GetX() > m_maxX))
+        return false;
+
+    // ATTN As for the volume bounds, the rotated wire coordinates of U and V hits cannot be compared with the box in y and z
+    const HitType hitType(pCaloHit->GetHitType());
+
+    if (((TPC_VIEW_W == hitType) || (TPC_3D == hitType)) && ((position.GetZ() < m_minZ) || (position.GetZ() > m_maxZ)))
+        return false;
+
+    if ((TPC_3D == hitType) && ((position.GetY() < m_minY) || (position.GetY() > m_maxY)))
+        return false;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool HitFilterAlgorithm::IsInDetectorGap(const CaloHit *const pCaloHit) const
+{
+    for (const DetectorGap *const pDetectorGap : this->GetPandora().GetGeometry()->GetDetectorGapList())
+    {
+        if (pDetectorGap->IsInGap(pCaloHit->GetPositionVector(), pCaloHit->GetHitType(), m_gapTolerance))
+            return true;
+    }
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode HitFilterAlgorithm::ReadSettings(const TiXmlHandle xmlHandle)
+{
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "OutputCaloHitListName", m_outputCaloHitListName));
+
+    IntVector volumeIds;
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadVectorOfValues(xmlHandle, "LArTPCVolumeIds", volumeIds));
+
+    for (const int volumeId : volumeIds)
+    {
+        if (volumeId < 0)
+            return STATUS_CODE_INVALID_PARAMETER;
+
+        m_volumeIds.insert(static_cast<unsigned int>(volumeId));
+    }
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle, "MinTime", m_minTime));
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle, "MaxTime", m_maxTime));
+
+    if (m_minTime > m_maxTime)
+    {
+        std::cout << "HitFilterAlgorithm::ReadSettings - MinTime " << m_minTime << " exceeds MaxTime " << m_maxTime << std::endl;
+        return STATUS_CODE_INVALID_PARAMETER;
+    }
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle, "MinX", m_minX));
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle, "MaxX", m_maxX));
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle, "MinY", m_minY));
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle, "MaxY", m_maxY));
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle, "MinZ", m_minZ));
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle, "MaxZ", m_maxZ));
+
+    if ((m_minX > m_maxX) || (m_minY > m_maxY) || (m_minZ > m_maxZ))
+    {
+        std::cout << "HitFilterAlgorithm::ReadSettings - each of MinX, MinY and MinZ must not exceed MaxX, MaxY and MaxZ respectively" << std::endl;
+        return STATUS_CODE_INVALID_PARAMETER;
+    }
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "ShouldUseLArTPCBounds", m_shouldUseVolumeBounds));
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "LArTPCBoundsTolerance", m_volumeBoundsTolerance));
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "ShouldRemoveGapHits", m_shouldRemoveGapHits));
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "GapTolerance", m_gapTolerance));
+
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle,
+        "ShouldPrintCounts", m_shouldPrintCounts));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+} // namespace lar_reco
@@ -0,0 +1,157 @@
+/**
+ *  @file   LArReco/src/JobCheckpoint.cxx
+ *
+ *  @brief  Implementation of the job checkpoint class.
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/StatusCodes.h"
+
+#include "EventFileHelper.h"
+#include "JobCheckpoint.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+const std::string JobCheckpoint::m_formatName("LArRecoCheckpoint 2");
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+JobCheckpoint::JobCheckpoint(const std::string &fileName) :
+    m_fileName(fileName),
+    m_eventFileNameList(""),
+    m_eventList(""),
+    m_nEventsToSkip(0),
+    m_nEventsToProcess(-1),
+    m_nEventsCompleted(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool JobCheckpoint::Read()
+{
+    std::ifstream inputFile(m_fileName);
+
+    if (!inputFile)
+        return false;
+
+    std::string line;
+
+    if (!std::getline(inputFile, line) || (m_formatName != line))
+    {
+        std::cout << "JobCheckpoint::Read - " << m_fileName << " is not a valid checkpoint file" << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    m_writtenFileList.clear();
+
+    while (std::getline(inputFile, line))
+    {
+        const std::size_t separator(line.find(' '));
+        const std::string key(line.substr(0, separator));
+        const std::string value((std::string::npos == separator) ? std::string() : line.substr(separator + 1));
+        std::istringstream valueStream(value);
+
+        if ("EventFileNameList" == key)
+        {
+            m_eventFileNameList = value;
+        }
+        else if ("EventList" == key)
+        {
+            m_eventList = value;
+        }
+        else if ("NEventsToSkip" == key)
+        {
+            valueStream >> m_nEventsToSkip;
+        }
+        else if ("NEventsToProcess" == key)
+        {
+            valueStream >> m_nEventsToProcess;
+        }
+        else if ("NEventsCompleted" == key)
+        {
+            valueStream >> m_nEventsCompleted;
+        }
+        else if ("WrittenEventFile" == key)
+        {
+            // ATTN The file name is last on the line, so that it may contain spaces
+            WrittenFile writtenFile;
+            valueStream >> writtenFile.m_nInitialEvents >> writtenFile.m_nEvents >> writtenFile.m_endOffset;
+            std::getline(valueStream >> std::ws, writtenFile.m_fileName);
+            m_writtenFileList.push_back(writtenFile);
+        }
+        else
+        {
+            valueStream.setstate(std::ios::failbit);
+        }
+
+        if (valueStream.fail())
+        {
+            std::cout << "JobCheckpoint::Read - invalid line in " << m_fileName << ": " << line << std::endl;
+            throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void JobCheckpoint::Write() const
+{
+    // ATTN Written alongside, then renamed, so that an interruption leaves the previous checkpoint intact
+    const std::string temporaryFileName(m_fileName + ".tmp");
+
+    {
+        std::ofstream outputFile(temporaryFileName);
+        outputFile << m_formatName << std::endl
+                   << "EventFileNameList " << m_eventFileNameList << std::endl
+                   << "EventList " << m_eventList << std::endl
+                   << "NEventsToSkip " << m_nEventsToSkip << std::endl
+                   << "NEventsToProcess " << m_nEventsToProcess << std::endl
+                   << "NEventsCompleted " << m_nEventsCompleted << std::endl;
+
+        for (const WrittenFile &writtenFile : m_writtenFileList)
+        {
+            outputFile << "WrittenEventFile " << writtenFile.m_nInitialEvents << " " << writtenFile.m_nEvents << " " << writtenFile.m_endOffset << " "
+                       << writtenFile.m_fileName << std::endl;
+        }
+
+        if (!outputFile.flush())
+        {
+            std::cout << "JobCheckpoint::Write - unable to write " << temporaryFileName << std::endl;
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+        }
+    }
+
+    if (0 != std::rename(temporaryFileName.c_str(), m_fileName.c_str()))
+    {
+        std::cout << "JobCheckpoint::Write - unable to replace " << m_fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void JobCheckpoint::AddCompletedEvent()
+{
+    ++m_nEventsCompleted;
+
+    // ATTN Counted from the files themselves, as an event may be written and then abandoned over its limits, and LArEventWriting may filter
+    // out events. An event container not yet flushed to its file by the writer is counted after a later event.
+    for (WrittenFile &writtenFile : m_writtenFileList)
+        EventFileHelper::UpdateCompleteEvents(writtenFile.m_fileName, writtenFile.m_nEvents, writtenFile.m_endOffset);
+
+    this->Write();
+}
+
+} // namespace lar_reco
@@ -0,0 +1,32 @@
+/**
+ *  @file   LArReco/src/LArRecoContent.cxx
+ *
+ *  @brief  Registration of the LArReco algorithms with pandora.
+ *
+ *  $Log: $
+ */
+
+#include "Api/PandoraApi.h"
+
+#include "AdaptiveMasterAlgorithm.h"
+#include "HitFilterAlgorithm.h"
+#include "LArRecoContent.h"
+#include "ProfilingAlgorithm.h"
+#include "ProfilingMasterAlgorithm.h"
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+StatusCode LArRecoContent::RegisterAlgorithms(const Pandora &pandora)
+{
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::RegisterAlgorithmFactory(pandora, "LArRecoAdaptiveMaster", new AdaptiveMasterAlgorithm::Factory));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::RegisterAlgorithmFactory(pandora, "LArRecoHitFilter", new HitFilterAlgorithm::Factory));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::RegisterAlgorithmFactory(pandora, "LArRecoProfiling", new ProfilingAlgorithm::Factory));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::RegisterAlgorithmFactory(pandora, "LArRecoProfilingMaster", new ProfilingMasterAlgorithm::Factory));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+} // namespace lar_reco
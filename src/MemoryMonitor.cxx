@@ -0,0 +1,225 @@
+/**
+ *  @file   LArReco/src/MemoryMonitor.cxx
+ *
+ *  @brief  Implementation of the memory monitor class.
+ *
+ *  $Log: $
+ */
+
+#include "MemoryMonitor.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+
+/**
+ *  @brief  EventMemory class, describing the memory used by the event in progress on the current thread
+ */
+class EventMemory
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    EventMemory();
+
+    bool                                    m_isInEvent;            ///< Whether an event is in progress
+    bool                                    m_hasSliceStageBegun;   ///< Whether a slicing or per-slice stage has begun during the event
+    long                                    m_baseline;             ///< The resident memory at the start of the event, units kB
+    long                                    m_overBudgetMemory;     ///< The resident memory when the budget was exceeded, units kB (or -1)
+    std::string                             m_overBudgetStage;      ///< The innermost stage in which the budget was exceeded
+    std::vector<std::string>                m_stageNames;           ///< The stages in progress, innermost last
+    lar_reco::MemoryMonitor::StagePeakMap   m_stagePeakMap;         ///< The peak resident memory for each stage, units kB
+};
+
+long g_budget(0);                           ///< The budget for the resident memory growth during each event, units kB
+thread_local EventMemory g_eventMemory;     ///< The memory used by the event in progress on the current thread
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventMemory::EventMemory() :
+    m_isInEvent(false),
+    m_hasSliceStageBegun(false),
+    m_baseline(-1),
+    m_overBudgetMemory(-1)
+{
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+MemoryMonitor::StageScope::StageScope(const std::string &stageName) :
+    m_isStage(MemoryMonitor::IsEnabled() && !stageName.empty())
+{
+    if (!m_isStage)
+        return;
+
+    g_eventMemory.m_stageNames.push_back(StageScope::GetReportedStageName(stageName));
+    (void)MemoryMonitor::CheckMemory();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+MemoryMonitor::StageScope::~StageScope()
+{
+    if (!m_isStage)
+        return;
+
+    (void)MemoryMonitor::CheckMemory();
+
+    if (!g_eventMemory.m_stageNames.empty())
+        g_eventMemory.m_stageNames.pop_back();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string MemoryMonitor::StageScope::GetReportedStageName(const std::string &stageName)
+{
+    EventMemory &eventMemory(g_eventMemory);
+
+    if ("CR" == stageName)
+        return eventMemory.m_hasSliceStageBegun ? "SliceReco" : "AllHitsCosmicReco";
+
+    if ("Slicing" == stageName)
+    {
+        eventMemory.m_hasSliceStageBegun = true;
+        return stageName;
+    }
+
+    if ("Nu" == stageName)
+    {
+        eventMemory.m_hasSliceStageBegun = true;
+        return "SliceReco";
+    }
+
+    return stageName;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void MemoryMonitor::SetBudget(const long budget)
+{
+    g_budget = std::max(0L, budget);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool MemoryMonitor::IsEnabled()
+{
+    return (g_budget > 0);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void MemoryMonitor::BeginEvent()
+{
+    EventMemory &eventMemory(g_eventMemory);
+    eventMemory.m_isInEvent = true;
+    eventMemory.m_hasSliceStageBegun = false;
+    eventMemory.m_baseline = MemoryMonitor::GetResidentMemory();
+    eventMemory.m_overBudgetMemory = -1;
+    eventMemory.m_overBudgetStage.clear();
+    eventMemory.m_stageNames.clear();
+    eventMemory.m_stagePeakMap.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void MemoryMonitor::EndEvent()
+{
+    EventMemory &eventMemory(g_eventMemory);
+    eventMemory.m_isInEvent = false;
+    eventMemory.m_stageNames.clear();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool MemoryMonitor::CheckMemory()
+{
+    EventMemory &eventMemory(g_eventMemory);
+
+    if (!MemoryMonitor::IsEnabled() || !eventMemory.m_isInEvent || (eventMemory.m_overBudgetMemory >= 0))
+        return (eventMemory.m_overBudgetMemory < 0);
+
+    const long residentMemory(MemoryMonitor::GetResidentMemory());
+
+    if ((residentMemory < 0) || (eventMemory.m_baseline < 0))
+        return true;
+
+    for (const std::string &stageName : eventMemory.m_stageNames)
+    {
+        long &stagePeak(eventMemory.m_stagePeakMap[stageName]);
+        stagePeak = std::max(stagePeak, residentMemory);
+    }
+
+    if (residentMemory - eventMemory.m_baseline <= g_budget)
+        return true;
+
+    eventMemory.m_overBudgetMemory = residentMemory;
+    eventMemory.m_overBudgetStage = eventMemory.m_stageNames.empty() ? std::string("unknown") : eventMemory.m_stageNames.back();
+
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool MemoryMonitor::IsEventOverBudget()
+{
+    return (g_eventMemory.m_overBudgetMemory >= 0);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string MemoryMonitor::GetOverBudgetDescription()
+{
+    const EventMemory &eventMemory(g_eventMemory);
+
+    if (eventMemory.m_overBudgetMemory < 0)
+        return std::string();
+
+    return "resident memory grew by " + std::to_string(eventMemory.m_overBudgetMemory - eventMemory.m_baseline) + " kB (budget " +
+        std::to_string(g_budget) + " kB) in stage " + eventMemory.m_overBudgetStage;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const MemoryMonitor::StagePeakMap &MemoryMonitor::GetStagePeakMemory()
+{
+    return g_eventMemory.m_stagePeakMap;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+long MemoryMonitor::GetResidentMemory()
+{
+    // ATTN Read with a stack buffer, as this is called between algorithms and should neither allocate nor perturb the allocation counts
+    const int fd(open("/proc/self/statm", O_RDONLY));
+
+    if (fd < 0)
+        return -1;
+
+    char buffer[128];
+    const ssize_t nBytes(read(fd, buffer, sizeof(buffer) - 1));
+    close(fd);
+
+    if (nBytes <= 0)
+        return -1;
+
+    buffer[nBytes] = '\0';
+    char *pEnd(nullptr);
+    (void)std::strtol(buffer, &pEnd, 10);
+    const long nResidentPages(std::strtol(pEnd, nullptr, 10));
+
+    return nResidentPages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+} // namespace lar_reco
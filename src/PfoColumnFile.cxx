@@ -0,0 +1,125 @@
+/**
+ *  @file   LArReco/src/PfoColumnFile.cxx
+ *
+ *  @brief  Implementation of the pfo column file class.
+ *
+ *  $Log: $
+ */
+
+#include "PfoColumnFile.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+const char PfoColumnFile::m_magicNumber[8] = {'L', 'A', 'R', 'P', 'F', 'O', 'C', '\n'};
+const std::uint32_t PfoColumnFile::m_formatVersion(1);
+const std::size_t PfoColumnFile::m_columnAlignment(64);
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+PfoColumnFile::PfoColumnFile(const std::string &fileName) :
+    m_pAddress(nullptr),
+    m_size(0),
+    m_pFileHeader(nullptr),
+    m_pColumnRecords(nullptr)
+{
+    static_assert((16 == sizeof(FileHeader)) && (56 == sizeof(ColumnRecord)), "PfoColumnFile: unexpected record size");
+
+    const int fd(open(fileName.c_str(), O_RDONLY));
+    struct stat fileStat;
+
+    if ((fd < 0) || (0 != fstat(fd, &fileStat)) || (static_cast<std::size_t>(fileStat.st_size) < sizeof(FileHeader)))
+    {
+        if (fd >= 0)
+            close(fd);
+
+        std::cout << "PfoColumnFile - unable to read " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+    }
+
+    m_size = fileStat.st_size;
+    m_pAddress = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (MAP_FAILED == m_pAddress)
+    {
+        std::cout << "PfoColumnFile - unable to map " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    const char *const pBytes(static_cast<const char *>(m_pAddress));
+    m_pFileHeader = reinterpret_cast<const FileHeader *>(pBytes);
+    m_pColumnRecords = reinterpret_cast<const ColumnRecord *>(pBytes + sizeof(FileHeader));
+
+    bool isValid((0 == std::memcmp(m_pFileHeader->m_magic, m_magicNumber, sizeof(m_magicNumber))) && (m_formatVersion == m_pFileHeader->m_version) &&
+        (sizeof(FileHeader) + m_pFileHeader->m_nColumns * sizeof(ColumnRecord) <= m_size));
+
+    // ATTN Columns are aligned within the file, and the mapping is page-aligned, so aligned columns can be used in place
+    for (std::uint32_t iColumn = 0; isValid && (iColumn < m_pFileHeader->m_nColumns); ++iColumn)
+    {
+        const ColumnRecord &columnRecord(m_pColumnRecords[iColumn]);
+        isValid = (0 != columnRecord.m_elementSize) && (0 == columnRecord.m_offset % m_columnAlignment) && (columnRecord.m_offset <= m_size) &&
+            (columnRecord.m_nElements <= (m_size - columnRecord.m_offset) / columnRecord.m_elementSize) &&
+            (nullptr != std::memchr(columnRecord.m_name, '\0', sizeof(columnRecord.m_name)));
+    }
+
+    if (!isValid)
+    {
+        munmap(m_pAddress, m_size);
+        std::cout << "PfoColumnFile - invalid or unsupported pfo column file " << fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+PfoColumnFile::~PfoColumnFile()
+{
+    munmap(m_pAddress, m_size);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool PfoColumnFile::IsPfoColumnFile(const std::string &fileName)
+{
+    char magic[sizeof(m_magicNumber)] = {0};
+    std::ifstream inputFile(fileName, std::ios::binary);
+
+    return (inputFile.read(magic, sizeof(magic)) && (0 == std::memcmp(magic, m_magicNumber, sizeof(m_magicNumber))));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+const PfoColumnFile::ColumnRecord &PfoColumnFile::FindColumn(const std::string &columnName, const std::size_t elementSize) const
+{
+    for (std::uint32_t iColumn = 0; iColumn < m_pFileHeader->m_nColumns; ++iColumn)
+    {
+        const ColumnRecord &columnRecord(m_pColumnRecords[iColumn]);
+
+        if (columnName != columnRecord.m_name)
+            continue;
+
+        if (elementSize != columnRecord.m_elementSize)
+        {
+            std::cout << "PfoColumnFile - column " << columnName << " has values of " << columnRecord.m_elementSize << " bytes, not " << elementSize << std::endl;
+            throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+        }
+
+        return columnRecord;
+    }
+
+    std::cout << "PfoColumnFile - no column named " << columnName << std::endl;
+    throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+}
+
+} // namespace lar_reco
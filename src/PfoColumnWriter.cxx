@@ -0,0 +1,363 @@
+/**
+ *  @file   LArReco/src/PfoColumnWriter.cxx
+ *
+ *  @brief  Implementation of the pfo column writer class.
+ *
+ *  $Log: $
+ */
+
+#include "Objects/CaloHit.h"
+#include "Objects/ParticleFlowObject.h"
+#include "Objects/Vertex.h"
+
+#include "larpandoracontent/LArHelpers/LArPfoHelper.h"
+
+#include "PfoColumnFile.h"
+#include "PfoColumnWriter.h"
+
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+PfoColumnWriter::PfoColumnWriter(const std::string &fileName, const unsigned int nParts) :
+    m_fileName(fileName),
+    m_parts(nParts),
+    m_isClosed(false)
+{
+    if (m_parts.empty())
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    // ATTN Names and sizes must follow the ColumnIndex order
+    const std::vector<std::pair<std::string, std::uint32_t>> columnDefinitions{{"EventFileIndex", sizeof(std::uint32_t)},
+        {"EventNumber", sizeof(std::int32_t)}, {"EventPfoBegin", sizeof(std::uint64_t)}, {"PfoPdgCode", sizeof(std::int32_t)},
+        {"PfoParent", sizeof(std::int32_t)}, {"PfoVertexX", sizeof(float)}, {"PfoVertexY", sizeof(float)}, {"PfoVertexZ", sizeof(float)},
+        {"PfoTrackScore", sizeof(float)}, {"PfoNuScore", sizeof(float)}, {"PfoIsClearCosmic", sizeof(float)}, {"PfoSliceIndex", sizeof(float)},
+        {"PfoHitBegin", sizeof(std::uint64_t)}, {"HitType", sizeof(std::uint8_t)}, {"HitX", sizeof(float)}, {"HitY", sizeof(float)},
+        {"HitZ", sizeof(float)}, {"HitEnergy", sizeof(float)}, {"FileNames", sizeof(char)}};
+
+    static_assert(N_COLUMNS == 19, "PfoColumnWriter: column definitions out of step with ColumnIndex");
+
+    for (unsigned int iPart = 0; iPart < m_parts.size(); ++iPart)
+    {
+        Part &part(m_parts.at(iPart));
+        part.m_nPfos = 0;
+        part.m_nHits = 0;
+
+        for (unsigned int iColumn = 0; iColumn < columnDefinitions.size(); ++iColumn)
+        {
+            const auto &columnDefinition(columnDefinitions.at(iColumn));
+            const bool isFileNames(FILE_NAMES == iColumn);
+
+            Column column;
+            column.m_name = columnDefinition.first;
+            column.m_elementSize = columnDefinition.second;
+            column.m_fileName = isFileNames ? std::string() : m_fileName + "." + std::to_string(iPart) + "." + column.m_name + ".tmp";
+            column.m_pFile = isFileNames ? nullptr : std::fopen(column.m_fileName.c_str(), "w+b");
+            column.m_nElements = 0;
+            part.m_columns.push_back(column);
+
+            if (!isFileNames && !column.m_pFile)
+            {
+                std::cout << "PfoColumnWriter - unable to open temporary column file " << column.m_fileName << std::endl;
+                this->RemoveColumnFiles();
+                throw StatusCodeException(STATUS_CODE_FAILURE);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+PfoColumnWriter::~PfoColumnWriter()
+{
+    this->RemoveColumnFiles();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void PfoColumnWriter::AddEvent(const unsigned int partIndex, const std::string &eventFileNameList, const int eventNumber, const PfoList &pfoList)
+{
+    if (m_isClosed)
+        throw StatusCodeException(STATUS_CODE_NOT_ALLOWED);
+
+    Part &part(m_parts.at(partIndex));
+    ColumnList &columns(part.m_columns);
+    FileIndexMap::const_iterator fileIter(part.m_fileIndexMap.find(eventFileNameList));
+
+    if (part.m_fileIndexMap.end() == fileIter)
+    {
+        fileIter = part.m_fileIndexMap.emplace(eventFileNameList, static_cast<std::uint32_t>(part.m_eventFileNameLists.size())).first;
+        part.m_eventFileNameLists.push_back(eventFileNameList);
+    }
+
+    PfoColumnWriter::Append(columns.at(EVENT_FILE_INDEX), fileIter->second);
+    PfoColumnWriter::Append(columns.at(EVENT_NUMBER), static_cast<std::int32_t>(eventNumber));
+    PfoColumnWriter::Append(columns.at(EVENT_PFO_BEGIN), part.m_nPfos);
+
+    PfoVector pfoVector(pfoList.begin(), pfoList.end());
+    std::unordered_map<const ParticleFlowObject *, std::int32_t> pfoIndexMap;
+
+    for (unsigned int iPfo = 0; iPfo < pfoVector.size(); ++iPfo)
+        pfoIndexMap.emplace(pfoVector.at(iPfo), static_cast<std::int32_t>(iPfo));
+
+    for (unsigned int iPfo = 0; iPfo < pfoVector.size(); ++iPfo)
+    {
+        for (const ParticleFlowObject *const pDaughterPfo : pfoVector.at(iPfo)->GetDaughterPfoList())
+        {
+            if (pfoIndexMap.emplace(pDaughterPfo, static_cast<std::int32_t>(pfoVector.size())).second)
+                pfoVector.push_back(pDaughterPfo);
+        }
+    }
+
+    const float missingValue(std::numeric_limits<float>::quiet_NaN());
+    const std::vector<std::pair<ColumnIndex, std::string>> propertyColumns{{PFO_TRACK_SCORE, "TrackScore"}, {PFO_NU_SCORE, "NuScore"},
+        {PFO_IS_CLEAR_COSMIC, "IsClearCosmic"}, {PFO_SLICE_INDEX, "SliceIndex"}};
+
+    for (const ParticleFlowObject *const pPfo : pfoVector)
+    {
+        const PfoList &parentPfoList(pPfo->GetParentPfoList());
+        const auto parentIter(parentPfoList.empty() ? pfoIndexMap.end() : pfoIndexMap.find(parentPfoList.front()));
+
+        PfoColumnWriter::Append(columns.at(PFO_PDG_CODE), static_cast<std::int32_t>(pPfo->GetParticleId()));
+        PfoColumnWriter::Append(columns.at(PFO_PARENT), (pfoIndexMap.end() == parentIter) ? static_cast<std::int32_t>(-1) : parentIter->second);
+
+        const VertexList &vertexList(pPfo->GetVertexList());
+        PfoColumnWriter::Append(columns.at(PFO_VERTEX_X), vertexList.empty() ? missingValue : vertexList.front()->GetPosition().GetX());
+        PfoColumnWriter::Append(columns.at(PFO_VERTEX_Y), vertexList.empty() ? missingValue : vertexList.front()->GetPosition().GetY());
+        PfoColumnWriter::Append(columns.at(PFO_VERTEX_Z), vertexList.empty() ? missingValue : vertexList.front()->GetPosition().GetZ());
+
+        const PropertiesMap &propertiesMap(pPfo->GetPropertiesMap());
+
+        for (const auto &propertyColumn : propertyColumns)
+        {
+            const PropertiesMap::const_iterator propertyIter(propertiesMap.find(propertyColumn.second));
+            PfoColumnWriter::Append(columns.at(propertyColumn.first), (propertiesMap.end() == propertyIter) ? missingValue : propertyIter->second);
+        }
+
+        PfoColumnWriter::Append(columns.at(PFO_HIT_BEGIN), part.m_nHits);
+        ++part.m_nPfos;
+
+        for (const HitType hitType : {TPC_VIEW_U, TPC_VIEW_V, TPC_VIEW_W, TPC_3D})
+        {
+            CaloHitList caloHitList;
+            lar_content::LArPfoHelper::GetCaloHits(pPfo, hitType, caloHitList);
+
+            for (const CaloHit *const pCaloHit : caloHitList)
+            {
+                const CartesianVector &position(pCaloHit->GetPositionVector());
+                PfoColumnWriter::Append(columns.at(HIT_TYPE), static_cast<std::uint8_t>(hitType));
+                PfoColumnWriter::Append(columns.at(HIT_X), position.GetX());
+                PfoColumnWriter::Append(columns.at(HIT_Y), position.GetY());
+                PfoColumnWriter::Append(columns.at(HIT_Z), position.GetZ());
+                PfoColumnWriter::Append(columns.at(HIT_ENERGY), pCaloHit->GetInputEnergy());
+                ++part.m_nHits;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void PfoColumnWriter::Close()
+{
+    if (m_isClosed)
+        return;
+
+    m_isClosed = true;
+
+    // ATTN An event file list shared by several parts, as when threads take ranges of events from a single file, is written once
+    FileIndexMap fileIndexMap;
+    std::string fileNames;
+    std::vector<std::vector<std::uint32_t>> partFileIndices;
+
+    for (const Part &part : m_parts)
+    {
+        partFileIndices.emplace_back();
+
+        for (const std::string &eventFileNameList : part.m_eventFileNameLists)
+        {
+            const auto insertion(fileIndexMap.emplace(eventFileNameList, static_cast<std::uint32_t>(fileIndexMap.size())));
+
+            if (insertion.second)
+                fileNames += eventFileNameList + '\n';
+
+            partFileIndices.back().push_back(insertion.first->second);
+        }
+    }
+
+    std::uint64_t nPfos(0), nHits(0);
+    std::vector<std::uint64_t> partPfoBegins, partHitBegins;
+
+    for (const Part &part : m_parts)
+    {
+        partPfoBegins.push_back(nPfos);
+        partHitBegins.push_back(nHits);
+        nPfos += part.m_nPfos;
+        nHits += part.m_nHits;
+    }
+
+    const ColumnList &firstColumns(m_parts.front().m_columns);
+
+    PfoColumnFile::FileHeader fileHeader;
+    std::memcpy(fileHeader.m_magic, PfoColumnFile::m_magicNumber, sizeof(PfoColumnFile::m_magicNumber));
+    fileHeader.m_version = PfoColumnFile::m_formatVersion;
+    fileHeader.m_nColumns = firstColumns.size();
+
+    std::vector<PfoColumnFile::ColumnRecord> columnRecords(firstColumns.size());
+    std::uint64_t offset(sizeof(PfoColumnFile::FileHeader) + firstColumns.size() * sizeof(PfoColumnFile::ColumnRecord));
+
+    for (unsigned int iColumn = 0; iColumn < firstColumns.size(); ++iColumn)
+    {
+        const Column &column(firstColumns.at(iColumn));
+
+        // ATTN The offset columns end with the total, so that the values of the last event and pfo are delimited like all others
+        std::uint64_t nElements(((EVENT_PFO_BEGIN == iColumn) || (PFO_HIT_BEGIN == iColumn)) ? 1 : 0);
+
+        for (const Part &part : m_parts)
+            nElements += part.m_columns.at(iColumn).m_nElements;
+
+        PfoColumnFile::ColumnRecord &columnRecord(columnRecords.at(iColumn));
+        std::memset(&columnRecord, 0, sizeof(PfoColumnFile::ColumnRecord));
+        std::strncpy(columnRecord.m_name, column.m_name.c_str(), sizeof(columnRecord.m_name) - 1);
+        columnRecord.m_elementSize = column.m_elementSize;
+        columnRecord.m_offset = (offset + PfoColumnFile::m_columnAlignment - 1) / PfoColumnFile::m_columnAlignment * PfoColumnFile::m_columnAlignment;
+        columnRecord.m_nElements = (FILE_NAMES == iColumn) ? fileNames.size() : nElements;
+        offset = columnRecord.m_offset + columnRecord.m_nElements * column.m_elementSize;
+    }
+
+    // ATTN Written to a temporary file then renamed, so that the output file is never seen incomplete
+    const std::string temporaryFileName(m_fileName + ".tmp");
+    std::FILE *const pOutputFile(std::fopen(temporaryFileName.c_str(), "wb"));
+    bool isWritten(nullptr != pOutputFile);
+
+    if (isWritten)
+    {
+        isWritten = (1 == std::fwrite(&fileHeader, sizeof(fileHeader), 1, pOutputFile)) &&
+            (columnRecords.size() == std::fwrite(columnRecords.data(), sizeof(PfoColumnFile::ColumnRecord), columnRecords.size(), pOutputFile));
+
+        std::vector<char> buffer(1 << 20);
+
+        for (unsigned int iColumn = 0; isWritten && (iColumn < columnRecords.size()); ++iColumn)
+        {
+            const ColumnIndex columnIndex(static_cast<ColumnIndex>(iColumn));
+            const std::vector<char> padding(columnRecords.at(iColumn).m_offset - std::ftell(pOutputFile), '\0');
+            isWritten = (padding.size() == std::fwrite(padding.data(), 1, padding.size(), pOutputFile));
+
+            if (FILE_NAMES == columnIndex)
+            {
+                isWritten = isWritten && (fileNames.size() == std::fwrite(fileNames.data(), 1, fileNames.size(), pOutputFile));
+                continue;
+            }
+
+            for (unsigned int iPart = 0; isWritten && (iPart < m_parts.size()); ++iPart)
+            {
+                const std::uint64_t offsetBase((EVENT_PFO_BEGIN == columnIndex) ? partPfoBegins.at(iPart) : partHitBegins.at(iPart));
+                isWritten = PfoColumnWriter::CopyColumn(m_parts.at(iPart).m_columns.at(iColumn), columnIndex, offsetBase, partFileIndices.at(iPart),
+                    buffer, pOutputFile);
+            }
+
+            if ((EVENT_PFO_BEGIN == columnIndex) || (PFO_HIT_BEGIN == columnIndex))
+            {
+                const std::uint64_t total((EVENT_PFO_BEGIN == columnIndex) ? nPfos : nHits);
+                isWritten = isWritten && (1 == std::fwrite(&total, sizeof(total), 1, pOutputFile));
+            }
+        }
+
+        isWritten = (0 == std::fclose(pOutputFile)) && isWritten;
+    }
+
+    this->RemoveColumnFiles();
+
+    if (!isWritten || (0 != std::rename(temporaryFileName.c_str(), m_fileName.c_str())))
+    {
+        std::remove(temporaryFileName.c_str());
+        std::cout << "PfoColumnWriter - unable to write " << m_fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    std::cout << "PfoColumnWriter, wrote " << columnRecords.at(EVENT_NUMBER).m_nElements << " events, " << nPfos << " pfos and " << nHits
+              << " hits to " << m_fileName << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+void PfoColumnWriter::Append(Column &column, const T &value)
+{
+    if (sizeof(T) != column.m_elementSize)
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    if (1 != std::fwrite(&value, sizeof(T), 1, column.m_pFile))
+    {
+        std::cout << "PfoColumnWriter - unable to write temporary column file " << column.m_fileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    ++column.m_nElements;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool PfoColumnWriter::CopyColumn(const Column &column, const ColumnIndex columnIndex, const std::uint64_t offsetBase,
+    const std::vector<std::uint32_t> &fileIndices, std::vector<char> &buffer, std::FILE *const pOutputFile)
+{
+    if ((0 != std::fflush(column.m_pFile)) || (0 != std::fseek(column.m_pFile, 0, SEEK_SET)))
+        return false;
+
+    // ATTN Read whole values, so that each value to be rebased lies within the buffer
+    const std::size_t bufferElements(buffer.size() / column.m_elementSize);
+
+    for (std::size_t nElements = 0; 0 != (nElements = std::fread(buffer.data(), column.m_elementSize, bufferElements, column.m_pFile));)
+    {
+        for (std::size_t iElement = 0; iElement < nElements; ++iElement)
+        {
+            char *const pValue(buffer.data() + iElement * column.m_elementSize);
+
+            if (EVENT_FILE_INDEX == columnIndex)
+            {
+                std::uint32_t fileIndex(0);
+                std::memcpy(&fileIndex, pValue, sizeof(fileIndex));
+                fileIndex = fileIndices.at(fileIndex);
+                std::memcpy(pValue, &fileIndex, sizeof(fileIndex));
+            }
+            else if ((EVENT_PFO_BEGIN == columnIndex) || (PFO_HIT_BEGIN == columnIndex))
+            {
+                std::uint64_t valueOffset(0);
+                std::memcpy(&valueOffset, pValue, sizeof(valueOffset));
+                valueOffset += offsetBase;
+                std::memcpy(pValue, &valueOffset, sizeof(valueOffset));
+            }
+        }
+
+        if (nElements != std::fwrite(buffer.data(), column.m_elementSize, nElements, pOutputFile))
+            return false;
+    }
+
+    return (0 == std::ferror(column.m_pFile));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void PfoColumnWriter::RemoveColumnFiles()
+{
+    for (Part &part : m_parts)
+    {
+        for (Column &column : part.m_columns)
+        {
+            if (!column.m_pFile)
+                continue;
+
+            std::fclose(column.m_pFile);
+            std::remove(column.m_fileName.c_str());
+            column.m_pFile = nullptr;
+        }
+    }
+}
+
+} // namespace lar_reco
@@ -0,0 +1,51 @@
+/**
+ *  @file   LArReco/src/ProfilingAlgorithm.cxx
+ *
+ *  @brief  Implementation of the profiling algorithm class.
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/AlgorithmHeaders.h"
+
+#include "AlgorithmProfiler.h"
+#include "EventWatchdog.h"
+#include "MemoryMonitor.h"
+#include "ProfilingAlgorithm.h"
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+StatusCode ProfilingAlgorithm::Run()
+{
+    const MemoryMonitor::StageScope stageScope(m_stageName);
+
+    // ATTN Once over budget or time, the remaining algorithms are skipped, whether or not the failure is propagated by their parents
+    if (!MemoryMonitor::CheckMemory() || EventWatchdog::IsEventOverTime())
+        return STATUS_CODE_OUT_OF_RANGE;
+
+    StatusCode statusCode(STATUS_CODE_SUCCESS);
+    {
+        const AlgorithmProfiler::Scope scope(m_profiledAlgorithmType);
+        statusCode = PandoraContentApi::RunDaughterAlgorithm(*this, m_profiledAlgorithmName);
+    }
+
+    const bool isWithinTime(EventWatchdog::CheckTime(m_profiledAlgorithmType));
+
+    return (MemoryMonitor::CheckMemory() && isWithinTime) ? statusCode : STATUS_CODE_OUT_OF_RANGE;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+StatusCode ProfilingAlgorithm::ReadSettings(const TiXmlHandle xmlHandle)
+{
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ProcessAlgorithm(*this, xmlHandle, "ProfiledAlgorithm", m_profiledAlgorithmName));
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, XmlHelper::ReadValue(xmlHandle, "ProfiledAlgorithmType", m_profiledAlgorithmType));
+    PANDORA_RETURN_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_FOUND, !=, XmlHelper::ReadValue(xmlHandle, "Stage", m_stageName));
+
+    return STATUS_CODE_SUCCESS;
+}
+
+} // namespace lar_reco
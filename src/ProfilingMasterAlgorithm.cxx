@@ -0,0 +1,26 @@
+/**
+ *  @file   LArReco/src/ProfilingMasterAlgorithm.cxx
+ *
+ *  @brief  Implementation of the profiling master algorithm class.
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/AlgorithmHeaders.h"
+
+#include "LArRecoContent.h"
+#include "ProfilingMasterAlgorithm.h"
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+StatusCode ProfilingMasterAlgorithm::RegisterCustomContent(const Pandora *const pPandora) const
+{
+    PANDORA_RETURN_RESULT_IF(STATUS_CODE_SUCCESS, !=, lar_content::MasterAlgorithm::RegisterCustomContent(pPandora));
+
+    return LArRecoContent::RegisterAlgorithms(*pPandora);
+}
+
+} // namespace lar_reco
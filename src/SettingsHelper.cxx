@@ -0,0 +1,324 @@
+/**
+ *  @file   LArReco/src/SettingsHelper.cxx
+ *
+ *  @brief  Implementation of the settings helper class.
+ *
+ *  $Log: $
+ */
+
+#include "Helpers/XmlHelper.h"
+#include "Pandora/StatusCodes.h"
+#include "Xml/tinyxml.h"
+
+#include "EventFileHelper.h"
+#include "SettingsHelper.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <ftw.h>
+#include <sys/stat.h>
+#include <iostream>
+#include <vector>
+
+using namespace pandora;
+
+namespace lar_reco
+{
+
+std::string SettingsHelper::FindFileInPath(const std::string &unqualifiedFileName, const std::string &environmentVariable)
+{
+    const char *const pFileSearchPath(std::getenv(environmentVariable.c_str()));
+
+    if (!pFileSearchPath)
+    {
+        std::cout << "SettingsHelper::FindFileInPath - environment variable " << environmentVariable << " not set" << std::endl;
+        throw StatusCodeException(STATUS_CODE_NOT_INITIALIZED);
+    }
+
+    StringVector filePaths;
+    XmlHelper::TokenizeString(pFileSearchPath, filePaths, ":");
+
+    for (const std::string &filePath : filePaths)
+    {
+        const std::string qualifiedFileName(filePath + "/" + unqualifiedFileName);
+
+        if (std::ifstream(qualifiedFileName))
+            return qualifiedFileName;
+    }
+
+    std::cout << "SettingsHelper::FindFileInPath - unable to find file " << unqualifiedFileName << " in " << environmentVariable << std::endl;
+    throw StatusCodeException(STATUS_CODE_NOT_FOUND);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string SettingsHelper::GetBaseName(const std::string &fileName)
+{
+    const std::string::size_type slashPosition(fileName.find_last_of('/'));
+
+    return (std::string::npos == slashPosition) ? fileName : fileName.substr(slashPosition + 1);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string SettingsHelper::CreateTemporaryDirectory(const std::string &parentDirectory)
+{
+    const char *const pTemporaryPath(std::getenv("TMPDIR"));
+    const std::string directoryTemplate((parentDirectory.empty() ? std::string(pTemporaryPath ? pTemporaryPath : "/tmp") : parentDirectory) +
+        "/LArReco.XXXXXX");
+
+    std::vector<char> directoryName(directoryTemplate.begin(), directoryTemplate.end());
+    directoryName.push_back('\0');
+
+    if (!mkdtemp(directoryName.data()))
+    {
+        std::cout << "SettingsHelper::CreateTemporaryDirectory - unable to create " << directoryTemplate << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    return std::string(directoryName.data());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SettingsHelper::RemoveDirectory(const std::string &directoryName)
+{
+    struct stat directoryStat;
+
+    if (directoryName.empty() || (0 != stat(directoryName.c_str(), &directoryStat)))
+        return;
+
+    const auto removeEntry = [](const char *pPath, const struct stat *, int, struct FTW *) -> int { return std::remove(pPath); };
+
+    if (0 != nftw(directoryName.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS))
+        std::cout << "SettingsHelper::RemoveDirectory - unable to remove " << directoryName << std::endl;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+std::string SettingsHelper::RewriteSettings(const std::string &settingsFile, const std::string &outputDirectory, const bool shouldProfile,
+    const std::string &stageName, SettingsTree &settingsTree)
+{
+    TiXmlDocument xmlDocument(settingsFile);
+
+    if (!xmlDocument.LoadFile())
+    {
+        std::cout << "SettingsHelper::RewriteSettings - invalid xml file " << settingsFile << ", " << xmlDocument.ErrorDesc() << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    TiXmlElement *const pRootElement(xmlDocument.RootElement());
+
+    if (!pRootElement)
+    {
+        std::cout << "SettingsHelper::RewriteSettings - no root element in " << settingsFile << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    settingsTree.m_sourceFiles.push_back(settingsFile);
+    SettingsHelper::ProcessElements(pRootElement, outputDirectory, shouldProfile, true, stageName, settingsTree);
+
+    TiXmlPrinter xmlPrinter;
+    xmlPrinter.SetIndent("");
+    xmlPrinter.SetLineBreak("");
+    pRootElement->Accept(&xmlPrinter);
+
+    const std::string outputFileName(outputDirectory + "/" + SettingsHelper::GetBaseName(settingsFile));
+    std::ofstream outputFile(outputFileName);
+
+    if (!(outputFile << xmlPrinter.Str() << std::endl))
+    {
+        std::cout << "SettingsHelper::RewriteSettings - unable to write " << outputFileName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    return outputFileName;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SettingsHelper::PrependSearchPath(const SettingsTree &settingsTree, const std::string &directoryName)
+{
+    StringVector environmentVariables(settingsTree.m_searchPathVariables);
+    std::sort(environmentVariables.begin(), environmentVariables.end());
+    environmentVariables.erase(std::unique(environmentVariables.begin(), environmentVariables.end()), environmentVariables.end());
+
+    for (const std::string &environmentVariable : environmentVariables)
+    {
+        const char *const pFileSearchPath(std::getenv(environmentVariable.c_str()));
+        const std::string fileSearchPath(directoryName + (pFileSearchPath ? std::string(":") + pFileSearchPath : std::string()));
+
+        if (0 != setenv(environmentVariable.c_str(), fileSearchPath.c_str(), 1))
+            throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SettingsHelper::GetWrittenEventFiles(const std::string &settingsFile, StringVector &eventFileNames)
+{
+    TiXmlDocument xmlDocument(settingsFile);
+
+    if (!xmlDocument.LoadFile() || !xmlDocument.RootElement())
+    {
+        std::cout << "SettingsHelper::GetWrittenEventFiles - invalid xml file " << settingsFile << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    SettingsHelper::CollectWrittenEventFiles(xmlDocument.RootElement(), false, eventFileNames);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SettingsHelper::GetOverwrittenEventFiles(const std::string &settingsFile, StringVector &eventFileNames)
+{
+    TiXmlDocument xmlDocument(settingsFile);
+
+    if (!xmlDocument.LoadFile() || !xmlDocument.RootElement())
+    {
+        std::cout << "SettingsHelper::GetOverwrittenEventFiles - invalid xml file " << settingsFile << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    SettingsHelper::CollectWrittenEventFiles(xmlDocument.RootElement(), true, eventFileNames);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SettingsHelper::ProcessElements(TiXmlElement *const pParentElement, const std::string &outputDirectory, const bool shouldProfile,
+    const bool isTopLevel, const std::string &stageName, SettingsTree &settingsTree)
+{
+    TiXmlNode *pNextNode(pParentElement->FirstChild());
+
+    while (nullptr != pNextNode)
+    {
+        TiXmlNode *const pNode(pNextNode);
+        pNextNode = pNode->NextSibling();
+
+        if (TiXmlNode::TINYXML_COMMENT == pNode->Type())
+        {
+            pParentElement->RemoveChild(pNode);
+            continue;
+        }
+
+        TiXmlElement *const pElement(pNode->ToElement());
+
+        if (!pElement)
+            continue;
+
+        SettingsHelper::ProcessElements(pElement, outputDirectory, shouldProfile, false, std::string(), settingsTree);
+
+        if ("algorithm" != pElement->ValueStr())
+            continue;
+
+        const char *const pType(pElement->Attribute("type"));
+
+        if (!pType)
+        {
+            std::cout << "SettingsHelper::ProcessElements - algorithm element without type in " << settingsTree.m_sourceFiles.back() << std::endl;
+            throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+        }
+
+        const std::string algorithmType(pType);
+
+        if ("LArMaster" == algorithmType)
+            SettingsHelper::ProcessMasterAlgorithm(pElement, outputDirectory, shouldProfile, settingsTree);
+
+        if (!shouldProfile)
+            continue;
+
+        // ATTN The wrapper takes over any description, by which a parent algorithm may identify this daughter
+        TiXmlElement wrapperElement("algorithm");
+        wrapperElement.SetAttribute("type", "LArRecoProfiling");
+
+        if (const char *const pDescription = pElement->Attribute("description"))
+            wrapperElement.SetAttribute("description", pDescription);
+
+        TiXmlElement typeElement("ProfiledAlgorithmType");
+        typeElement.InsertEndChild(TiXmlText(algorithmType.c_str()));
+        wrapperElement.InsertEndChild(typeElement);
+
+        if (isTopLevel)
+        {
+            TiXmlElement stageElement("Stage");
+            stageElement.InsertEndChild(TiXmlText(stageName.empty() ? algorithmType.c_str() : stageName.c_str()));
+            wrapperElement.InsertEndChild(stageElement);
+        }
+
+        TiXmlElement profiledElement(*pElement);
+        profiledElement.SetAttribute("description", "ProfiledAlgorithm");
+        wrapperElement.InsertEndChild(profiledElement);
+
+        pParentElement->ReplaceChild(pElement, wrapperElement);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SettingsHelper::ProcessMasterAlgorithm(TiXmlElement *const pMasterElement, const std::string &outputDirectory, const bool shouldProfile,
+    SettingsTree &settingsTree)
+{
+    std::string environmentVariable("FW_SEARCH_PATH");
+
+    if (const TiXmlElement *const pVariableElement = pMasterElement->FirstChildElement("FilePathEnvironmentVariable"))
+    {
+        if (pVariableElement->GetText())
+            environmentVariable = pVariableElement->GetText();
+    }
+
+    const std::string settingsFileSuffix("SettingsFile");
+
+    for (const TiXmlElement *pElement = pMasterElement->FirstChildElement(); nullptr != pElement; pElement = pElement->NextSiblingElement())
+    {
+        const std::string &elementName(pElement->ValueStr());
+
+        if ((elementName.size() <= settingsFileSuffix.size()) || !pElement->GetText() ||
+            (0 != elementName.compare(elementName.size() - settingsFileSuffix.size(), settingsFileSuffix.size(), settingsFileSuffix)))
+        {
+            continue;
+        }
+
+        const std::string workerSettingsFile(SettingsHelper::FindFileInPath(pElement->GetText(), environmentVariable));
+        const std::string workerStageName(elementName.substr(0, elementName.size() - settingsFileSuffix.size()));
+        (void)SettingsHelper::RewriteSettings(workerSettingsFile, outputDirectory, shouldProfile, workerStageName, settingsTree);
+    }
+
+    settingsTree.m_searchPathVariables.push_back(environmentVariable);
+
+    // ATTN Retype the master, so that its worker instances are able to run the profiling algorithms
+    if (shouldProfile)
+        pMasterElement->SetAttribute("type", "LArRecoProfilingMaster");
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SettingsHelper::CollectWrittenEventFiles(const TiXmlElement *const pElement, const bool overwrittenOnly, StringVector &eventFileNames)
+{
+    const char *const pAlgorithmType(pElement->Attribute("type"));
+
+    if (("algorithm" == pElement->ValueStr()) && pAlgorithmType && (std::string("LArEventWriting") == pAlgorithmType))
+    {
+        // ATTN Mirrors the EventWritingAlgorithm defaults: events are only written if requested, and are appended to any existing file
+        const TiXmlElement *const pShouldWriteElement(pElement->FirstChildElement("ShouldWriteEvents"));
+        const TiXmlElement *const pShouldOverwriteElement(pElement->FirstChildElement("ShouldOverwriteEventFile"));
+        const TiXmlElement *const pFileNameElement(pElement->FirstChildElement("EventFileName"));
+        const bool shouldOverwrite(pShouldOverwriteElement && pShouldOverwriteElement->GetText() &&
+            (std::string("true") == pShouldOverwriteElement->GetText()));
+
+        if (pShouldWriteElement && pShouldWriteElement->GetText() && (std::string("true") == pShouldWriteElement->GetText()) && pFileNameElement &&
+            pFileNameElement->GetText() && EventFileHelper::IsBinaryFile(pFileNameElement->GetText()) && (shouldOverwrite || !overwrittenOnly))
+        {
+            eventFileNames.push_back(pFileNameElement->GetText());
+        }
+    }
+
+    for (const TiXmlElement *pChildElement = pElement->FirstChildElement(); nullptr != pChildElement;
+         pChildElement = pChildElement->NextSiblingElement())
+    {
+        SettingsHelper::CollectWrittenEventFiles(pChildElement, overwrittenOnly, eventFileNames);
+    }
+}
+
+} // namespace lar_reco
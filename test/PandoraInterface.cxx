@@ -22,15 +22,44 @@
 #include "larpandoradlcontent/LArDLContent.h"
 #endif
 
+#include "AlgorithmProfiler.h"
+#include "AllocationCounter.h"
+#include "BinaryGeometry.h"
+#include "CompressedEventFile.h"
+#include "EventDecompressor.h"
+#include "EventFileHelper.h"
+#include "EventPrefetcher.h"
+#include "EventStatistics.h"
+#include "EventWatchdog.h"
+#include "HitFilterAlgorithm.h"
+#include "JobCheckpoint.h"
+#include "LArRecoContent.h"
+#include "MemoryMonitor.h"
 #include "PandoraInterface.h"
+#include "PfoColumnWriter.h"
+#include "SettingsHelper.h"
 
 #ifdef MONITORING
 #include "TApplication.h"
 #endif
 
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <getopt.h>
+#include <iomanip>
 #include <iostream>
+#include <malloc.h>
+#include <memory>
+#include <sstream>
 #include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
 
 using namespace pandora;
 using namespace lar_reco;
@@ -38,55 +67,790 @@ using namespace lar_reco;
 int main(int argc, char *argv[])
 {
     int errorNo(0);
-    const Pandora *pPrimaryPandora(nullptr);
+    Parameters parameters;
+    std::string profilingDirectory;
+    std::unique_ptr<const BinaryGeometry> pBinaryGeometry;
+    EventStatistics eventStatistics;
 
     try
     {
-        Parameters parameters;
+        if (!ParseCommandLine(argc, argv, parameters))
+            return 1;
+
+        MemoryMonitor::SetBudget(1024L * parameters.m_memoryBudget);
+        EventWatchdog::SetTimeLimit(parameters.m_eventTimeLimit);
+        EventWatchdog::SetHardTimeLimit((parameters.m_eventHardTimeLimit < 0.) ? 2. * parameters.m_eventTimeLimit : parameters.m_eventHardTimeLimit);
+
+        // ATTN Memory and time limits are checked between the wrapped algorithms, so use the same rewritten settings as profiling
+        if (ShouldWrapAlgorithms(parameters))
+            PrepareProfiling(parameters, profilingDirectory);
+
+        // ATTN A binary geometry is mapped once per process and copied into each instance directly, rather than parsed by LArEventReading
+        if (!parameters.m_geometryFileName.empty() && BinaryGeometry::IsBinaryGeometryFile(parameters.m_geometryFileName))
+        {
+            pBinaryGeometry.reset(new BinaryGeometry(parameters.m_geometryFileName));
+            parameters.m_geometryFileName.clear();
+        }
+
+#ifdef MONITORING
+        TApplication *pTApplication = new TApplication("LArReco", &argc, argv);
+        pTApplication->SetReturnFromRun(kTRUE);
+#endif
+        if (!parameters.m_daemonSocketName.empty())
+        {
+            RunDaemon(parameters, pBinaryGeometry.get());
+        }
+        else if (!RunJob(parameters, pBinaryGeometry.get(), eventStatistics))
+        {
+            errorNo = 1;
+        }
+    }
+    catch (const StatusCodeException &statusCodeException)
+    {
+        std::cerr << "Pandora StatusCodeException: " << statusCodeException.ToString() << statusCodeException.GetBackTrace() << std::endl;
+        errorNo = 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception: " << std::endl;
+        errorNo = 1;
+    }
+
+    // ATTN In daemon mode, the event log and profiling report are written for each job instead
+    const bool isSingleJob(parameters.m_daemonSocketName.empty());
+
+    if (isSingleJob && !parameters.m_eventLogFileName.empty())
+    {
+        try
+        {
+            eventStatistics.WriteEventLog(parameters.m_eventLogFileName);
+        }
+        catch (const StatusCodeException &)
+        {
+            errorNo = 1;
+        }
+    }
+
+    if (isSingleJob && !parameters.m_profilingFileName.empty())
+    {
+        try
+        {
+            AlgorithmProfiler::GetInstance().WriteReport(parameters.m_profilingFileName);
+        }
+        catch (const StatusCodeException &)
+        {
+            errorNo = 1;
+        }
+    }
+
+    if (!profilingDirectory.empty())
+        SettingsHelper::RemoveDirectory(profilingDirectory);
+
+    return errorNo;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+namespace lar_reco
+{
+
+void PrepareProfiling(Parameters &parameters, std::string &profilingDirectory)
+{
+    AlgorithmProfiler::GetInstance().SetShouldStoreEvents(parameters.m_shouldProfileEvents);
+
+    profilingDirectory = SettingsHelper::CreateTemporaryDirectory();
+
+    SettingsHelper::SettingsTree settingsTree;
+    parameters.m_settingsFile = SettingsHelper::RewriteSettings(parameters.m_settingsFile, profilingDirectory, true, std::string(), settingsTree);
+    SettingsHelper::PrependSearchPath(settingsTree, profilingDirectory);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool ShouldWrapAlgorithms(const Parameters &parameters)
+{
+    return (!parameters.m_profilingFileName.empty() || (parameters.m_memoryBudget > 0) || (parameters.m_eventTimeLimit > 0.));
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool RunJob(const Parameters &parameters, const BinaryGeometry *const pBinaryGeometry, EventStatistics &eventStatistics)
+{
+    Parameters jobParameters(parameters);
+    ParametersList threadParametersList;
+    std::string eventDirectory;
+    std::unique_ptr<EventDecompressor> pEventDecompressor;
+    std::unique_ptr<JobCheckpoint> pJobCheckpoint;
+    std::unique_ptr<PfoColumnWriter> pPfoColumnWriter;
+
+    bool isPrepared(PrepareCheckpoint(jobParameters, pJobCheckpoint) && PrepareEventFiles(jobParameters, eventDirectory, pEventDecompressor) &&
+        GetThreadParameters(jobParameters, threadParametersList));
+
+    for (Parameters &threadParameters : threadParametersList)
+        isPrepared = isPrepared && SelectEvents(threadParameters, eventDirectory);
+
+    if (!isPrepared)
+    {
+        pEventDecompressor.reset();
+        SettingsHelper::RemoveDirectory(eventDirectory);
+        return false;
+    }
+
+    bool success(true);
+    PrimaryPandoraList primaryPandoraList;
+    auto startTime(std::chrono::steady_clock::now());
+
+    try
+    {
+        if (!jobParameters.m_pfoFileName.empty())
+            pPfoColumnWriter.reset(new PfoColumnWriter(jobParameters.m_pfoFileName, threadParametersList.size()));
+
+        for (const Parameters &threadParameters : threadParametersList)
+        {
+            primaryPandoraList.push_back(nullptr);
+            CreatePandoraInstances(threadParameters, pBinaryGeometry, primaryPandoraList.back());
+
+            if (!primaryPandoraList.back())
+                throw StatusCodeException(STATUS_CODE_FAILURE);
+        }
+
+        startTime = std::chrono::steady_clock::now();
+
+        if (1 == primaryPandoraList.size())
+        {
+            ProcessEvents(threadParametersList.front(), primaryPandoraList.front(), pEventDecompressor.get(), pJobCheckpoint.get(),
+                pPfoColumnWriter.get(), eventStatistics);
+        }
+        else
+        {
+            ProcessEventsMultiThreaded(threadParametersList, primaryPandoraList, pPfoColumnWriter.get(), eventStatistics);
+        }
+    }
+    catch (const StatusCodeException &statusCodeException)
+    {
+        std::cerr << "Pandora StatusCodeException: " << statusCodeException.ToString() << statusCodeException.GetBackTrace() << std::endl;
+        success = false;
+    }
+    catch (const StopProcessingException &)
+    {
+        // Exit gracefully
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception: " << std::endl;
+        success = false;
+    }
+
+    const std::chrono::duration<double> wallTime(std::chrono::steady_clock::now() - startTime);
+    eventStatistics.DisplaySummary(wallTime.count());
+
+    // ATTN Pfos are only added for completed events, so the events processed before any failure are still written
+    try
+    {
+        if (pPfoColumnWriter)
+            pPfoColumnWriter->Close();
+    }
+    catch (const StatusCodeException &)
+    {
+        success = false;
+    }
+
+    for (const Pandora *const pPrimaryPandora : primaryPandoraList)
+        MultiPandoraApi::DeletePandoraInstances(pPrimaryPandora);
+
+    // ATTN The decompressor must have stopped writing before its output directory is removed
+    pEventDecompressor.reset();
+    SettingsHelper::RemoveDirectory(eventDirectory);
+
+    // ATTN Event files are only complete once the instances, and so their file writers, have been deleted
+    if (success)
+        IndexWrittenEventFiles(parameters.m_settingsFile);
+
+    return success;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void RunDaemon(const Parameters &parameters, const BinaryGeometry *const pBinaryGeometry)
+{
+    const std::string &socketName(parameters.m_daemonSocketName);
+    struct sockaddr_un socketAddress;
+
+    if (socketName.size() >= sizeof(socketAddress.sun_path))
+    {
+        std::cout << "LArReco, daemon socket name too long: " << socketName << std::endl;
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+    }
+
+    std::memset(&socketAddress, 0, sizeof(socketAddress));
+    socketAddress.sun_family = AF_UNIX;
+    std::strncpy(socketAddress.sun_path, socketName.c_str(), sizeof(socketAddress.sun_path) - 1);
+
+    const int socketFd(socket(AF_UNIX, SOCK_STREAM, 0));
+    unlink(socketName.c_str());
+
+    if ((socketFd < 0) || (0 != bind(socketFd, reinterpret_cast<const struct sockaddr *>(&socketAddress), sizeof(socketAddress))) ||
+        (0 != listen(socketFd, 16)))
+    {
+        std::cout << "LArReco, unable to listen on daemon socket " << socketName << std::endl;
+        throw StatusCodeException(STATUS_CODE_FAILURE);
+    }
+
+    std::cout << "LArReco, daemon listening on " << socketName << std::endl;
+
+    while (true)
+    {
+        const int connectionFd(accept(socketFd, nullptr, nullptr));
+
+        if (connectionFd < 0)
+        {
+            if (EINTR == errno)
+                continue;
+
+            break;
+        }
+
+        // ATTN A client that connects but never completes its request must not block the daemon, so each read and the reply are time limited
+        struct timeval requestTimeout;
+        requestTimeout.tv_sec = 10;
+        requestTimeout.tv_usec = 0;
+        (void)setsockopt(connectionFd, SOL_SOCKET, SO_RCVTIMEO, &requestTimeout, sizeof(requestTimeout));
+        (void)setsockopt(connectionFd, SOL_SOCKET, SO_SNDTIMEO, &requestTimeout, sizeof(requestTimeout));
+
+        std::string request, reply;
+        const bool isRequestComplete(ReadJobRequest(connectionFd, request));
+        const bool shouldShutdown(isRequestComplete && ("shutdown" == request));
+        Parameters jobParameters(parameters);
+
+        if (!isRequestComplete)
+        {
+            reply = "ERROR incomplete request";
+        }
+        else if (shouldShutdown)
+        {
+            reply = "OK shutdown";
+        }
+        else if (!ParseJobRequest(request, jobParameters))
+        {
+            reply = "ERROR invalid request";
+        }
+        else
+        {
+            EventStatistics eventStatistics;
+            const auto startTime(std::chrono::steady_clock::now());
+            bool success(RunJob(jobParameters, pBinaryGeometry, eventStatistics));
+            const std::chrono::duration<double> wallTime(std::chrono::steady_clock::now() - startTime);
+
+            if (!jobParameters.m_eventLogFileName.empty())
+            {
+                try
+                {
+                    eventStatistics.WriteEventLog(jobParameters.m_eventLogFileName);
+                }
+                catch (const StatusCodeException &)
+                {
+                    success = false;
+                }
+            }
+
+            // ATTN The profiler is shared by every job the daemon serves, so each job writes its own report and then clears the totals
+            if (!jobParameters.m_profilingFileName.empty())
+            {
+                try
+                {
+                    AlgorithmProfiler::GetInstance().WriteReport(jobParameters.m_profilingFileName);
+                }
+                catch (const StatusCodeException &)
+                {
+                    success = false;
+                }
+            }
+
+            AlgorithmProfiler::GetInstance().Reset();
+
+            reply = std::string(success ? "OK " : "ERROR ") + std::to_string(eventStatistics.GetNumberOfEvents()) + " events " +
+                std::to_string(wallTime.count()) + " s";
+        }
+
+        reply += "\n";
+        (void)send(connectionFd, reply.c_str(), reply.size(), MSG_NOSIGNAL);
+        close(connectionFd);
+
+        if (shouldShutdown)
+            break;
+    }
+
+    close(socketFd);
+    unlink(socketName.c_str());
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool ReadJobRequest(const int connectionFd, std::string &request)
+{
+    const std::size_t maxRequestSize(65536);
+    char buffer[4096];
+
+    while (request.size() < maxRequestSize)
+    {
+        const ssize_t nBytes(recv(connectionFd, buffer, sizeof(buffer), 0));
+
+        if ((nBytes < 0) && (EINTR == errno))
+            continue;
+
+        // ATTN A timed-out read fails with EAGAIN; a client closing its end without a newline still completes its request
+        if (nBytes <= 0)
+            return (0 == nBytes);
+
+        request.append(buffer, nBytes);
+        const std::size_t newlinePosition(request.find('\n'));
+
+        if (std::string::npos != newlinePosition)
+        {
+            request.resize(newlinePosition);
+            return true;
+        }
+    }
+
+    std::cout << "LArReco, daemon job request exceeds " << maxRequestSize << " bytes" << std::endl;
+    return false;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool ParseJobRequest(const std::string &request, Parameters &parameters)
+{
+    // ATTN Job requests describe the events to process; instance-level configuration (settings, geometry, threads) is fixed for the daemon
+    parameters.m_nEventsToProcess = -1;
+    parameters.m_nEventsToSkip.Reset();
+    parameters.m_eventList.clear();
+    parameters.m_eventNumberList.clear();
+    parameters.m_eventLogFileName.clear();
+    parameters.m_pfoFileName.clear();
+    parameters.m_checkpointFileName.clear();
+    parameters.m_shouldResume = false;
+
+    std::istringstream requestStream(request);
+    std::string option, recoOption;
+
+    while (requestStream >> option)
+    {
+        if ("-p" == option)
+        {
+            parameters.m_printOverallRecoStatus = true;
+            continue;
+        }
+
+        if ("-N" == option)
+        {
+            parameters.m_shouldDisplayEventNumber = true;
+            continue;
+        }
+
+        std::string value;
+
+        if (!(requestStream >> value))
+            return false;
+
+        if ("-r" == option)
+        {
+            recoOption = value;
+        }
+        else if ("-e" == option)
+        {
+            parameters.m_eventFileNameList = value;
+        }
+        else if ("-n" == option)
+        {
+            parameters.m_nEventsToProcess = std::atoi(value.c_str());
+        }
+        else if ("-s" == option)
+        {
+            parameters.m_nEventsToSkip = std::atoi(value.c_str());
+        }
+        else if ("-L" == option)
+        {
+            parameters.m_eventList = value;
+        }
+        else if ("-l" == option)
+        {
+            parameters.m_eventLogFileName = value;
+        }
+        else if ("-o" == option)
+        {
+            parameters.m_pfoFileName = value;
+        }
+        else if (("-P" == option) && !parameters.m_profilingFileName.empty())
+        {
+            // ATTN Profiling relies on the settings rewritten when the daemon starts, so a job can only redirect the report of a profiling daemon
+            parameters.m_profilingFileName = value;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return ProcessRecoOption(recoOption, parameters);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool PrepareCheckpoint(Parameters &parameters, std::unique_ptr<JobCheckpoint> &pJobCheckpoint)
+{
+    if (parameters.m_checkpointFileName.empty())
+        return true;
+
+    if (parameters.m_nThreads > 1)
+    {
+        std::cout << "LArReco, a checkpoint requires single-threaded event processing" << std::endl;
+        return false;
+    }
+
+    // ATTN The pfo file is written whole at the end of each job, so a resumed job would replace the pfos of the events already completed
+    if (!parameters.m_pfoFileName.empty())
+    {
+        std::cout << "LArReco, a checkpoint cannot be combined with columnar pfo output" << std::endl;
+        return false;
+    }
+
+    try
+    {
+        pJobCheckpoint.reset(new JobCheckpoint(parameters.m_checkpointFileName));
+        const int nEventsToSkip(parameters.m_nEventsToSkip.IsInitialized() ? parameters.m_nEventsToSkip.Get() : 0);
+
+        StringVector overwrittenFileNames;
+        SettingsHelper::GetOverwrittenEventFiles(parameters.m_settingsFile, overwrittenFileNames);
+
+        if (parameters.m_shouldResume && pJobCheckpoint->Read())
+        {
+            if ((pJobCheckpoint->m_eventFileNameList != parameters.m_eventFileNameList) || (pJobCheckpoint->m_eventList != parameters.m_eventList) ||
+                (pJobCheckpoint->m_nEventsToSkip != nEventsToSkip) || (pJobCheckpoint->m_nEventsToProcess != parameters.m_nEventsToProcess))
+            {
+                std::cout << "LArReco, checkpoint " << parameters.m_checkpointFileName << " describes a different job" << std::endl;
+                return false;
+            }
+
+            // ATTN An overwriting writer would discard the events written before the checkpoint
+            if (!overwrittenFileNames.empty())
+            {
+                std::cout << "LArReco, unable to resume, as LArEventWriting overwrites " << overwrittenFileNames.front() << std::endl;
+                return false;
+            }
+
+            for (const JobCheckpoint::WrittenFile &writtenFile : pJobCheckpoint->m_writtenFileList)
+            {
+                if (!EventFileHelper::TruncateEvents(writtenFile.m_fileName, writtenFile.m_nEvents))
+                {
+                    std::cout << "LArReco, unable to restore " << writtenFile.m_fileName << " to checkpoint " << parameters.m_checkpointFileName << std::endl;
+                    return false;
+                }
+            }
+
+            std::cout << "LArReco, resuming after " << pJobCheckpoint->m_nEventsCompleted << " completed events, from checkpoint "
+                      << parameters.m_checkpointFileName << std::endl;
+
+            return AdvanceParameters(parameters, pJobCheckpoint->m_nEventsCompleted);
+        }
+
+        StringVector writtenFileNames;
+        SettingsHelper::GetWrittenEventFiles(parameters.m_settingsFile, writtenFileNames);
+
+        pJobCheckpoint->m_eventFileNameList = parameters.m_eventFileNameList;
+        pJobCheckpoint->m_eventList = parameters.m_eventList;
+        pJobCheckpoint->m_nEventsToSkip = nEventsToSkip;
+        pJobCheckpoint->m_nEventsToProcess = parameters.m_nEventsToProcess;
+
+        for (const std::string &writtenFileName : writtenFileNames)
+        {
+            const bool isOverwritten(overwrittenFileNames.end() != std::find(overwrittenFileNames.begin(), overwrittenFileNames.end(), writtenFileName));
+            JobCheckpoint::WrittenFile writtenFile{writtenFileName, 0, 0, 0};
+
+            if (!isOverwritten)
+                EventFileHelper::UpdateCompleteEvents(writtenFileName, writtenFile.m_nEvents, writtenFile.m_endOffset);
+
+            writtenFile.m_nInitialEvents = writtenFile.m_nEvents;
+            pJobCheckpoint->m_writtenFileList.push_back(writtenFile);
+        }
+
+        pJobCheckpoint->Write();
+    }
+    catch (const StatusCodeException &)
+    {
+        std::cout << "LArReco, unable to prepare checkpoint " << parameters.m_checkpointFileName << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool AdvanceParameters(Parameters &parameters, const unsigned int nEventsCompleted)
+{
+    if (0 == nEventsCompleted)
+        return true;
+
+    if (parameters.m_nEventsToProcess >= 0)
+        parameters.m_nEventsToProcess = std::max(0, parameters.m_nEventsToProcess - static_cast<int>(nEventsCompleted));
+
+    if (!parameters.m_eventList.empty())
+    {
+        std::vector<unsigned int> eventIndexList;
+
+        if (!ParseEventList(parameters.m_eventList, eventIndexList))
+            return false;
+
+        // ATTN An event list cannot be empty, so a completed list is retained, with nothing left to process
+        if (nEventsCompleted >= eventIndexList.size())
+        {
+            parameters.m_nEventsToProcess = 0;
+            return true;
+        }
+
+        std::ostringstream eventList;
+
+        for (unsigned int iEvent = nEventsCompleted; iEvent < eventIndexList.size(); ++iEvent)
+            eventList << ((iEvent > nEventsCompleted) ? "," : "") << eventIndexList.at(iEvent);
+
+        parameters.m_eventList = eventList.str();
+        return true;
+    }
+
+    StringVector eventFileNames;
+    XmlHelper::TokenizeString(parameters.m_eventFileNameList, eventFileNames, ":");
+
+    // ATTN The skip applies to the first file only, so files read in full are dropped from the list
+    unsigned int position((parameters.m_nEventsToSkip.IsInitialized() ? parameters.m_nEventsToSkip.Get() : 0) + nEventsCompleted), iFile(0);
+
+    for (; iFile + 1 < eventFileNames.size(); ++iFile)
+    {
+        const int nEvents(CountEvents(eventFileNames.at(iFile)));
+
+        if (nEvents < 0)
+        {
+            std::cout << "LArReco, unable to resume beyond " << eventFileNames.at(iFile) << ", as its events cannot be counted" << std::endl;
+            return false;
+        }
+
+        if (position < static_cast<unsigned int>(nEvents))
+            break;
+
+        position -= nEvents;
+    }
+
+    std::string eventFileNameList;
+
+    for (unsigned int jFile = iFile; jFile < eventFileNames.size(); ++jFile)
+        eventFileNameList += ((jFile > iFile) ? ":" : "") + eventFileNames.at(jFile);
+
+    parameters.m_eventFileNameList = eventFileNameList;
+    parameters.m_nEventsToSkip = static_cast<int>(position);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int CountEvents(const std::string &eventFileName)
+{
+    if (EventFileHelper::IsBinaryFile(eventFileName))
+    {
+        EventFileHelper::ContainerList containerList;
+        EventFileHelper::GetEventContainers(eventFileName, containerList);
+        return containerList.size();
+    }
+
+    if (CompressedEventFile::IsCompressedFile(eventFileName))
+    {
+        CompressedEventFile::BlockList blockList;
+        CompressedEventFile::ReadBlocks(eventFileName, blockList);
+        return std::count_if(blockList.begin(), blockList.end(), [](const CompressedEventFile::Block &block) { return block.m_isEventContainer; });
+    }
+
+    return -1;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool PrepareEventFiles(Parameters &parameters, std::string &eventDirectory, std::unique_ptr<EventDecompressor> &pEventDecompressor)
+{
+    // ATTN Events are read from decompressed or selected copies in a temporary directory, but reported against the files as given
+    parameters.m_inputFileNameList = parameters.m_eventFileNameList;
+
+    if (EventDecompressor::HasCompressedFiles(parameters.m_eventFileNameList))
+    {
+        try
+        {
+            if (eventDirectory.empty())
+                eventDirectory = SettingsHelper::CreateTemporaryDirectory();
+
+            pEventDecompressor.reset(new EventDecompressor(parameters.m_eventFileNameList, eventDirectory, std::max(1U, std::thread::hardware_concurrency())));
+            parameters.m_eventFileNameList = pEventDecompressor->GetEventFileNameList();
+        }
+        catch (const StatusCodeException &)
+        {
+            std::cout << "LArReco, unable to read compressed event files" << std::endl;
+            return false;
+        }
+
+        // ATTN Selecting events, or dividing them between threads, requires complete files; otherwise reconstruction starts with the first file
+        const bool shouldSelectEvents(!parameters.m_eventList.empty() ||
+            (parameters.m_nEventsToSkip.IsInitialized() && (parameters.m_nEventsToSkip.Get() > 0) && (parameters.m_nEventsToProcess >= 0)));
+
+        // ATTN Each decompressed file is only renamed into place once complete, and the first is opened when the instances are created
+        if (!((shouldSelectEvents || (parameters.m_nThreads > 1)) ? pEventDecompressor->WaitForAll() : pEventDecompressor->WaitForFile(0)))
+        {
+            std::cout << "LArReco, unable to decompress event files" << std::endl;
+            return false;
+        }
+    }
 
-        if (!ParseCommandLine(argc, argv, parameters))
-            return 1;
+    // ATTN An event list is resolved before events are divided between threads; each thread then selects its own range of events
+    return (parameters.m_eventList.empty() || SelectEvents(parameters, eventDirectory));
+}
 
-#ifdef MONITORING
-        TApplication *pTApplication = new TApplication("LArReco", &argc, argv);
-        pTApplication->SetReturnFromRun(kTRUE);
-#endif
-        CreatePandoraInstances(parameters, pPrimaryPandora);
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool SelectEvents(Parameters &parameters, std::string &eventDirectory)
+{
+    const int nEventsToSkip(parameters.m_nEventsToSkip.IsInitialized() ? parameters.m_nEventsToSkip.Get() : 0);
+    const bool hasEventList(!parameters.m_eventList.empty());
+
+    if (!hasEventList && ((nEventsToSkip <= 0) || (parameters.m_nEventsToProcess < 0)))
+        return true;
 
-        if (!pPrimaryPandora)
-            throw StatusCodeException(STATUS_CODE_FAILURE);
+    StringVector eventFileNames;
+    XmlHelper::TokenizeString(parameters.m_eventFileNameList, eventFileNames, ":");
 
-        ProcessEvents(parameters, pPrimaryPandora);
+    if ((1 != eventFileNames.size()) || !EventFileHelper::IsBinaryFile(eventFileNames.front()))
+    {
+        if (!hasEventList)
+            return true;
+
+        std::cout << "LArReco, an event list requires a single binary (.pndr) event file" << std::endl;
+        return false;
     }
-    catch (const StatusCodeException &statusCodeException)
+
+    const std::string eventFileName(eventFileNames.front());
+    EventFileHelper::ContainerList containerList;
+
+    if (!hasEventList && !EventFileHelper::ReadIndex(eventFileName, containerList))
+        return true;
+
+    EventFileHelper::EventIndexList eventIndexList;
+
+    if (hasEventList)
     {
-        std::cerr << "Pandora StatusCodeException: " << statusCodeException.ToString() << statusCodeException.GetBackTrace() << std::endl;
-        errorNo = 1;
+        if (!ParseEventList(parameters.m_eventList, eventIndexList))
+            return false;
+
+        if ((parameters.m_nEventsToProcess >= 0) && (static_cast<std::size_t>(parameters.m_nEventsToProcess) < eventIndexList.size()))
+            eventIndexList.resize(parameters.m_nEventsToProcess);
     }
-    catch (const StopProcessingException &)
+    else
     {
-        // Exit gracefully
-        errorNo = 0;
+        const unsigned int nEvents(containerList.size());
+        const unsigned int lastEvent(std::min(nEvents, static_cast<unsigned int>(nEventsToSkip + parameters.m_nEventsToProcess)));
+
+        for (unsigned int eventIndex = std::min(nEvents, static_cast<unsigned int>(nEventsToSkip)); eventIndex < lastEvent; ++eventIndex)
+            eventIndexList.push_back(eventIndex);
     }
-    catch (...)
+
+    try
     {
-        std::cerr << "Unknown exception: " << std::endl;
-        errorNo = 1;
+        if (eventDirectory.empty())
+            eventDirectory = SettingsHelper::CreateTemporaryDirectory();
+
+        const std::string selectionFileName(SettingsHelper::CreateTemporaryDirectory(eventDirectory) + "/" + SettingsHelper::GetBaseName(eventFileName));
+        EventFileHelper::WriteEventSelection(eventFileName, eventIndexList, selectionFileName);
+
+        IntVector eventNumberList;
+
+        for (const unsigned int eventIndex : eventIndexList)
+            eventNumberList.push_back(parameters.m_eventNumberList.empty() ? eventIndex : parameters.m_eventNumberList.at(eventIndex));
+
+        parameters.m_eventFileNameList = selectionFileName;
+        parameters.m_nEventsToSkip.Reset();
+        parameters.m_nEventsToProcess = eventIndexList.size();
+        parameters.m_eventList.clear();
+        parameters.m_eventNumberList = eventNumberList;
+    }
+    catch (const StatusCodeException &)
+    {
+        std::cout << "LArReco, unable to select events from " << parameters.m_inputFileNameList << std::endl;
+        return false;
     }
 
-    MultiPandoraApi::DeletePandoraInstances(pPrimaryPandora);
-    return errorNo;
+    return true;
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-namespace lar_reco
+bool ParseEventList(const std::string &eventList, std::vector<unsigned int> &eventIndexList)
+{
+    StringVector rangeStrings;
+    XmlHelper::TokenizeString(eventList, rangeStrings, ",");
+
+    for (const std::string &rangeString : rangeStrings)
+    {
+        StringVector limitStrings;
+        XmlHelper::TokenizeString(rangeString, limitStrings, "-");
+        unsigned int firstEvent(0), lastEvent(0);
+
+        if (limitStrings.empty() || (limitStrings.size() > 2) || !StringToType(limitStrings.front(), firstEvent) ||
+            !StringToType(limitStrings.back(), lastEvent) || (lastEvent < firstEvent))
+        {
+            std::cout << "LArReco, invalid event list entry " << rangeString << std::endl;
+            return false;
+        }
+
+        for (unsigned int eventIndex = firstEvent; eventIndex <= lastEvent; ++eventIndex)
+            eventIndexList.push_back(eventIndex);
+    }
+
+    return !eventIndexList.empty();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int GetEventNumber(const Parameters &parameters, const int eventIndex)
+{
+    if ((eventIndex >= 0) && (static_cast<std::size_t>(eventIndex) < parameters.m_eventNumberList.size()))
+        return parameters.m_eventNumberList.at(eventIndex);
+
+    return (parameters.m_nEventsToSkip.IsInitialized() ? parameters.m_nEventsToSkip.Get() : 0) + eventIndex;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void IndexWrittenEventFiles(const std::string &settingsFile)
 {
+    try
+    {
+        StringVector eventFileNames;
+        SettingsHelper::GetWrittenEventFiles(settingsFile, eventFileNames);
+
+        for (const std::string &eventFileName : eventFileNames)
+        {
+            const unsigned int nEvents(EventFileHelper::WriteIndex(eventFileName));
+            std::cout << "LArReco, indexed " << nEvents << " events in " << eventFileName << std::endl;
+        }
+    }
+    catch (const StatusCodeException &)
+    {
+        // ATTN The index is an optimisation only, so failing to write it does not fail the job
+        std::cout << "LArReco, unable to index written event files" << std::endl;
+    }
+}
 
-void CreatePandoraInstances(const Parameters &parameters, const Pandora *&pPrimaryPandora)
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void CreatePandoraInstances(const Parameters &parameters, const BinaryGeometry *const pBinaryGeometry, const Pandora *&pPrimaryPandora)
 {
     pPrimaryPandora = new Pandora();
     PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, LArContent::RegisterAlgorithms(*pPrimaryPandora));
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, LArRecoContent::RegisterAlgorithms(*pPrimaryPandora));
 #ifdef LIBTORCH_DL
     PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, LArDLContent::RegisterAlgorithms(*pPrimaryPandora));
 #endif
@@ -100,23 +864,395 @@ void CreatePandoraInstances(const Parameters &parameters, const Pandora *&pPrima
     ProcessExternalParameters(parameters, pPrimaryPandora);
     PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::SetPseudoLayerPlugin(*pPrimaryPandora, new lar_content::LArPseudoLayerPlugin));
     PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::SetLArTransformationPlugin(*pPrimaryPandora, new lar_content::LArRotationalTransformationPlugin));
+
+    if (pBinaryGeometry)
+        pBinaryGeometry->CreateGeometry(*pPrimaryPandora);
+
     PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::ReadSettings(*pPrimaryPandora, parameters.m_settingsFile));
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-void ProcessEvents(const Parameters &parameters, const Pandora *const pPrimaryPandora)
+void ProcessEvents(const Parameters &parameters, const Pandora *const pPrimaryPandora, EventDecompressor *const pEventDecompressor,
+    JobCheckpoint *const pJobCheckpoint, PfoColumnWriter *const pPfoColumnWriter, EventStatistics &eventStatistics)
 {
     int nEvents(0);
+    const int firstEvent(parameters.m_nEventsToSkip.IsInitialized() ? parameters.m_nEventsToSkip.Get() : 0);
+
+    // ATTN Files still being decompressed are awaited by the prefetcher, so one is always used alongside a decompressor
+    std::unique_ptr<EventPrefetcher> pEventPrefetcher(((parameters.m_prefetchDepth > 0) || pEventDecompressor)
+            ? new EventPrefetcher(parameters.m_eventFileNameList, firstEvent, parameters.m_prefetchDepth, pEventDecompressor)
+            : nullptr);
+
+    EventFileLocator eventFileLocator(parameters);
 
     while ((nEvents++ < parameters.m_nEventsToProcess) || (0 > parameters.m_nEventsToProcess))
     {
         if (parameters.m_shouldDisplayEventNumber)
             std::cout << std::endl << "   PROCESSING EVENT: " << (nEvents - 1) << std::endl << std::endl;
 
-        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::ProcessEvent(*pPrimaryPandora));
-        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Reset(*pPrimaryPandora));
+        ProcessSingleEvent(parameters, pPrimaryPandora, GetEventNumber(parameters, nEvents - 1), eventFileLocator, pEventPrefetcher.get(),
+            pJobCheckpoint, pPfoColumnWriter, 0, eventStatistics);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventScope::EventScope()
+{
+    MemoryMonitor::BeginEvent();
+    EventWatchdog::BeginEvent();
+    HitFilterAlgorithm::BeginEvent();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventScope::~EventScope()
+{
+    EventWatchdog::EndEvent();
+    MemoryMonitor::EndEvent();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+EventFileLocator::EventFileLocator(const Parameters &parameters)
+{
+    XmlHelper::TokenizeString(parameters.m_eventFileNameList, m_eventFileNames, ":");
+    XmlHelper::TokenizeString(parameters.m_inputFileNameList, m_inputFileNames, ":");
+
+    if (m_eventFileNames.size() != m_inputFileNames.size())
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void EventFileLocator::Locate(const int eventNumber, std::string &eventFileName, int &fileEventNumber)
+{
+    int position(eventNumber);
+    unsigned int iFile(0);
+
+    for (; iFile + 1 < m_eventFileNames.size(); ++iFile)
+    {
+        if (iFile == m_nFileEvents.size())
+            m_nFileEvents.push_back(CountEvents(m_eventFileNames.at(iFile)));
+
+        const int nEvents(m_nFileEvents.at(iFile));
+
+        if (nEvents < 0)
+            break;
+
+        if (position < nEvents)
+        {
+            eventFileName = m_inputFileNames.at(iFile);
+            fileEventNumber = position;
+            return;
+        }
+
+        position -= nEvents;
+    }
+
+    // ATTN The last file, or any file that cannot be counted (e.g. xml), holds the event; in the latter case the remaining files are named
+    eventFileName.clear();
+
+    for (unsigned int jFile = iFile; jFile < m_inputFileNames.size(); ++jFile)
+        eventFileName += ((jFile > iFile) ? ":" : "") + m_inputFileNames.at(jFile);
+
+    fileEventNumber = position;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ProcessSingleEvent(const Parameters &parameters, const Pandora *const pPrimaryPandora, const int eventNumber,
+    EventFileLocator &eventFileLocator, EventPrefetcher *const pEventPrefetcher, JobCheckpoint *const pJobCheckpoint, PfoColumnWriter *const pPfoColumnWriter,
+    const unsigned int threadIndex, EventStatistics &eventStatistics)
+{
+    EventStatistics::EventRecord eventRecord;
+    eventRecord.m_threadIndex = threadIndex;
+
+    if (pEventPrefetcher)
+        eventRecord.m_inputStallTime = pEventPrefetcher->WaitForNextEvent();
+
+    // ATTN The resident memory high-water mark is process-wide, so it cannot be attributed to one of several concurrent events
+    if (parameters.m_nThreads <= 1)
+        eventStatistics.StartEvent();
+
+    const unsigned long long startAllocations(AllocationCounter::GetThreadAllocationCount());
+    StatusCode processStatusCode(STATUS_CODE_SUCCESS);
+    std::chrono::steady_clock::time_point startTime, processTime;
+
+    {
+        const EventScope eventScope;
+        startTime = std::chrono::steady_clock::now();
+        processStatusCode = PandoraApi::ProcessEvent(*pPrimaryPandora);
+        processTime = std::chrono::steady_clock::now();
+    }
+
+    // ATTN The event has now been read, so every file up to and including its own is complete
+    eventFileLocator.Locate(eventNumber, eventRecord.m_eventFileName, eventRecord.m_eventNumber);
+
+    // ATTN An event over its memory budget or time limit, or without hits in the hit filter regions of interest, is abandoned, rather than the
+    // job; the reset below leaves the instance clean for the next event
+    const bool isEventOverLimit(MemoryMonitor::IsEventOverBudget() || EventWatchdog::IsEventOverTime());
+
+    if (isEventOverLimit)
+    {
+        const bool isOverBudget(MemoryMonitor::IsEventOverBudget());
+        eventRecord.m_skipReason = isOverBudget ? "MemoryBudget" : "TimeLimit";
+        std::cout << "LArReco, skipping event " << eventRecord.m_eventNumber << " from file " << eventRecord.m_eventFileName << ", "
+                  << (isOverBudget ? MemoryMonitor::GetOverBudgetDescription() : EventWatchdog::GetOverTimeDescription()) << std::endl;
+    }
+    else if (HitFilterAlgorithm::IsEventWithoutHits())
+    {
+        eventRecord.m_skipReason = "NoHitsInRegion";
+        std::cout << "LArReco, skipping event " << eventRecord.m_eventNumber << " from file " << eventRecord.m_eventFileName
+                  << ", no hits within the hit filter regions of interest" << std::endl;
+    }
+    else
+    {
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, processStatusCode);
+    }
+
+    if (!parameters.m_profilingFileName.empty())
+        AlgorithmProfiler::GetInstance().EndEvent(parameters.m_inputFileNameList, eventNumber);
+
+    // ATTN RecreatedPfos is the output list of LArMaster in all standard settings; a skipped event is written without pfos
+    if (pPfoColumnWriter)
+    {
+        const PfoList *pPfoList(nullptr);
+
+        if (eventRecord.m_skipReason.empty())
+            PANDORA_THROW_RESULT_IF_AND_IF(STATUS_CODE_SUCCESS, STATUS_CODE_NOT_INITIALIZED, !=, PandoraApi::GetPfoList(*pPrimaryPandora, "RecreatedPfos", pPfoList));
+
+        pPfoColumnWriter->AddEvent(threadIndex, parameters.m_inputFileNameList, eventNumber, pPfoList ? *pPfoList : PfoList());
+    }
+
+    const auto resetStartTime(std::chrono::steady_clock::now());
+    PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::Reset(*pPrimaryPandora));
+    const auto resetEndTime(std::chrono::steady_clock::now());
+
+    // ATTN Return the memory released by the reset to the system, so that a pathological event does not leave the job near its limit
+    if (isEventOverLimit)
+        (void)malloc_trim(0);
+
+    eventRecord.m_processTime = std::chrono::duration<double>(processTime - startTime).count();
+    eventRecord.m_resetTime = std::chrono::duration<double>(resetEndTime - resetStartTime).count();
+    eventRecord.m_peakResidentMemory = (parameters.m_nThreads <= 1) ? EventStatistics::GetPeakResidentMemory() : -1;
+    eventRecord.m_stagePeakResidentMemory = MemoryMonitor::GetStagePeakMemory();
+    eventRecord.m_nAllocations = static_cast<long>(AllocationCounter::GetThreadAllocationCount() - startAllocations);
+    eventRecord.m_nFilterInputHits = HitFilterAlgorithm::GetEventInputHits();
+    eventRecord.m_nFilterRemovedHits = HitFilterAlgorithm::GetEventRemovedHits();
+    eventStatistics.AddEvent(eventRecord);
+
+    if (pJobCheckpoint)
+        pJobCheckpoint->AddCompletedEvent();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool GetThreadParameters(const Parameters &parameters, ParametersList &threadParametersList)
+{
+    if (parameters.m_nThreads <= 1)
+    {
+        threadParametersList.push_back(parameters);
+        return true;
+    }
+
+#ifdef MONITORING
+    std::cout << "LArReco, multi-threaded processing is not supported in monitoring builds" << std::endl;
+    return false;
+#endif
+
+    // ATTN Resident memory is shared by all threads, so the growth measured for an event would include that of the concurrent events
+    if (parameters.m_memoryBudget > 0)
+    {
+        std::cout << "LArReco, multi-threaded processing cannot be combined with a per-event memory budget" << std::endl;
+        return false;
+    }
+
+    // ATTN Every thread runs the same settings, so each LArEventWriting instance would write to the same binary event file
+    try
+    {
+        StringVector writtenFileNames;
+        SettingsHelper::GetWrittenEventFiles(parameters.m_settingsFile, writtenFileNames);
+
+        if (!writtenFileNames.empty())
+        {
+            std::cout << "LArReco, multi-threaded processing cannot be combined with LArEventWriting, which writes " << writtenFileNames.front()
+                      << std::endl;
+            return false;
+        }
+    }
+    catch (const StatusCodeException &)
+    {
+        std::cout << "LArReco, unable to read settings " << parameters.m_settingsFile << std::endl;
+        return false;
+    }
+
+    StringVector eventFileNames, inputFileNames;
+    XmlHelper::TokenizeString(parameters.m_eventFileNameList, eventFileNames, ":");
+    XmlHelper::TokenizeString(parameters.m_inputFileNameList, inputFileNames, ":");
+
+    if (eventFileNames.size() > 1)
+    {
+        // ATTN Multiple files: each thread receives a contiguous block of whole files, the skip applying only to the very first file
+        if (parameters.m_nEventsToProcess >= 0)
+        {
+            std::cout << "LArReco, NEventsToProcess cannot be combined with multiple event files in multi-threaded mode" << std::endl;
+            return false;
+        }
+
+        const int nFiles(eventFileNames.size());
+        const int nThreads(std::min(nFiles, parameters.m_nThreads));
+
+        for (int iThread = 0, firstFile = 0; iThread < nThreads; ++iThread)
+        {
+            const int nThreadFiles(nFiles / nThreads + ((iThread < nFiles % nThreads) ? 1 : 0));
+
+            Parameters threadParameters(parameters);
+            threadParameters.m_eventFileNameList.clear();
+            threadParameters.m_inputFileNameList.clear();
+
+            // ATTN Decompression replaces files one for one, so the files as given are divided in step with those read
+            for (int iFile = firstFile; iFile < firstFile + nThreadFiles; ++iFile)
+            {
+                threadParameters.m_eventFileNameList += (threadParameters.m_eventFileNameList.empty() ? "" : ":") + eventFileNames.at(iFile);
+                threadParameters.m_inputFileNameList += (threadParameters.m_inputFileNameList.empty() ? "" : ":") + inputFileNames.at(iFile);
+            }
+
+            if (iThread > 0)
+                threadParameters.m_nEventsToSkip.Reset();
+
+            threadParametersList.push_back(threadParameters);
+            firstFile += nThreadFiles;
+        }
+    }
+    else
+    {
+        // ATTN Single file: each thread receives a contiguous range of events, so the total number of events must be specified
+        if (parameters.m_nEventsToProcess < 0)
+        {
+            std::cout << "LArReco, NEventsToProcess must be specified for a single event file in multi-threaded mode" << std::endl;
+            return false;
+        }
+
+        const int nEvents(parameters.m_nEventsToProcess);
+        const int nThreads(std::max(1, std::min(nEvents, parameters.m_nThreads)));
+        int firstEvent(parameters.m_nEventsToSkip.IsInitialized() ? parameters.m_nEventsToSkip.Get() : 0);
+
+        for (int iThread = 0; iThread < nThreads; ++iThread)
+        {
+            const int nThreadEvents(nEvents / nThreads + ((iThread < nEvents % nThreads) ? 1 : 0));
+
+            Parameters threadParameters(parameters);
+            threadParameters.m_nEventsToSkip = firstEvent;
+            threadParameters.m_nEventsToProcess = nThreadEvents;
+
+            threadParametersList.push_back(threadParameters);
+            firstEvent += nThreadEvents;
+        }
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ProcessEventsMultiThreaded(const ParametersList &threadParametersList, const PrimaryPandoraList &primaryPandoraList, PfoColumnWriter *const pPfoColumnWriter,
+    EventStatistics &eventStatistics)
+{
+    if (threadParametersList.size() != primaryPandoraList.size())
+        throw StatusCodeException(STATUS_CODE_INVALID_PARAMETER);
+
+    ThreadSummaryList threadSummaryList(primaryPandoraList.size());
+    std::vector<std::thread> threads;
+
+    const auto startTime(std::chrono::steady_clock::now());
+
+    for (unsigned int iThread = 0; iThread < primaryPandoraList.size(); ++iThread)
+    {
+        threads.emplace_back(ProcessEventsInThread, std::cref(threadParametersList.at(iThread)), primaryPandoraList.at(iThread), pPfoColumnWriter,
+            iThread, std::ref(eventStatistics), std::ref(threadSummaryList.at(iThread)));
+    }
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    const std::chrono::duration<double> wallTime(std::chrono::steady_clock::now() - startTime);
+    DisplayThreadSummaries(threadSummaryList, wallTime.count());
+
+    // ATTN Report failures in thread order, so that the outcome does not depend upon thread scheduling
+    for (const ThreadSummary &threadSummary : threadSummaryList)
+    {
+        if (threadSummary.m_exception)
+            std::rethrow_exception(threadSummary.m_exception);
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void ProcessEventsInThread(const Parameters &parameters, const Pandora *const pPrimaryPandora, PfoColumnWriter *const pPfoColumnWriter,
+    const unsigned int threadIndex, EventStatistics &eventStatistics, ThreadSummary &threadSummary)
+{
+    const auto startTime(std::chrono::steady_clock::now());
+    const int firstEvent(parameters.m_nEventsToSkip.IsInitialized() ? parameters.m_nEventsToSkip.Get() : 0);
+
+    try
+    {
+        std::unique_ptr<EventPrefetcher> pEventPrefetcher(
+            (parameters.m_prefetchDepth > 0) ? new EventPrefetcher(parameters.m_eventFileNameList, firstEvent, parameters.m_prefetchDepth, nullptr) : nullptr);
+        EventFileLocator eventFileLocator(parameters);
+
+        while ((threadSummary.m_nEventsProcessed < parameters.m_nEventsToProcess) || (0 > parameters.m_nEventsToProcess))
+        {
+            if (parameters.m_shouldDisplayEventNumber)
+            {
+                std::ostringstream eventNumberMessage;
+                eventNumberMessage << std::endl << "   PROCESSING EVENT: " << GetEventNumber(parameters, threadSummary.m_nEventsProcessed) << ", FILES: "
+                                   << parameters.m_inputFileNameList << std::endl << std::endl;
+                std::cout << eventNumberMessage.str();
+            }
+
+            ProcessSingleEvent(parameters, pPrimaryPandora, GetEventNumber(parameters, threadSummary.m_nEventsProcessed), eventFileLocator,
+                pEventPrefetcher.get(), nullptr, pPfoColumnWriter, threadIndex, eventStatistics);
+            ++threadSummary.m_nEventsProcessed;
+        }
+    }
+    catch (const StopProcessingException &)
+    {
+        // Reached the end of the events assigned to this thread
+    }
+    catch (...)
+    {
+        threadSummary.m_exception = std::current_exception();
+    }
+
+    const std::chrono::duration<double> wallTime(std::chrono::steady_clock::now() - startTime);
+    threadSummary.m_wallTime = wallTime.count();
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void DisplayThreadSummaries(const ThreadSummaryList &threadSummaryList, const double wallTime)
+{
+    int nTotalEvents(0);
+
+    std::ostringstream summary;
+    summary << std::endl << "LArReco, event-parallel processing summary" << std::endl << std::fixed << std::setprecision(3);
+
+    for (unsigned int iThread = 0; iThread < threadSummaryList.size(); ++iThread)
+    {
+        const ThreadSummary &threadSummary(threadSummaryList.at(iThread));
+        nTotalEvents += threadSummary.m_nEventsProcessed;
+
+        summary << "    Thread " << iThread << ": " << threadSummary.m_nEventsProcessed << " events, " << threadSummary.m_wallTime << " s, "
+                << ((threadSummary.m_wallTime > 0.) ? threadSummary.m_nEventsProcessed / threadSummary.m_wallTime : 0.) << " events/s"
+                << (threadSummary.m_exception ? " (failed)" : "") << std::endl;
     }
+
+    summary << "    Total: " << nTotalEvents << " events, " << wallTime << " s, " << ((wallTime > 0.) ? nTotalEvents / wallTime : 0.)
+            << " events/s" << std::endl << std::endl;
+
+    std::cout << summary.str();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -129,7 +1265,7 @@ bool ParseCommandLine(int argc, char *argv[], Parameters &parameters)
     int c(0);
     std::string recoOption;
 
-    while ((c = getopt(argc, argv, "r:i:e:g:n:s:pNh")) != -1)
+    while ((c = getopt(argc, argv, "r:i:e:g:n:s:L:t:f:M:T:H:C:Ro:D:P:El:pNh")) != -1)
     {
         switch (c)
         {
@@ -151,6 +1287,45 @@ bool ParseCommandLine(int argc, char *argv[], Parameters &parameters)
         case 's':
             parameters.m_nEventsToSkip = atoi(optarg);
             break;
+        case 'L':
+            parameters.m_eventList = optarg;
+            break;
+        case 't':
+            parameters.m_nThreads = atoi(optarg);
+            break;
+        case 'f':
+            parameters.m_prefetchDepth = atoi(optarg);
+            break;
+        case 'M':
+            parameters.m_memoryBudget = atoi(optarg);
+            break;
+        case 'T':
+            parameters.m_eventTimeLimit = atof(optarg);
+            break;
+        case 'H':
+            parameters.m_eventHardTimeLimit = atof(optarg);
+            break;
+        case 'C':
+            parameters.m_checkpointFileName = optarg;
+            break;
+        case 'R':
+            parameters.m_shouldResume = true;
+            break;
+        case 'o':
+            parameters.m_pfoFileName = optarg;
+            break;
+        case 'D':
+            parameters.m_daemonSocketName = optarg;
+            break;
+        case 'P':
+            parameters.m_profilingFileName = optarg;
+            break;
+        case 'E':
+            parameters.m_shouldProfileEvents = true;
+            break;
+        case 'l':
+            parameters.m_eventLogFileName = optarg;
+            break;
         case 'p':
             parameters.m_printOverallRecoStatus = true;
             break;
@@ -163,6 +1338,10 @@ bool ParseCommandLine(int argc, char *argv[], Parameters &parameters)
         }
     }
 
+    // ATTN In daemon mode, each job request carries its own reco option
+    if (!parameters.m_daemonSocketName.empty() && recoOption.empty())
+        return true;
+
     return ProcessRecoOption(recoOption, parameters);
 }
 
@@ -171,12 +1350,29 @@ bool ParseCommandLine(int argc, char *argv[], Parameters &parameters)
 bool PrintOptions()
 {
     std::cout << std::endl << "./bin/PandoraInterface " << std::endl
-              << "    -r RecoOption          (required) [Full, AllHitsCR, AllHitsNu, CRRemHitsSliceCR, CRRemHitsSliceNu, AllHitsSliceCR, AllHitsSliceNu]" << std::endl
+              << "    -r RecoOption          (required) [Full, AllHitsCR, AllHitsNu, CRRemHitsSliceCR, CRRemHitsSliceNu, AllHitsSliceCR, AllHitsSliceNu,"
+              << " Adaptive (steering chosen per event by LArRecoAdaptiveMaster)]" << std::endl
               << "    -i Settings            (required) [algorithm description: xml]" << std::endl
-              << "    -e EventFileList       (optional) [colon-separated list of files: xml/pndr]" << std::endl
-              << "    -g GeometryFile        (optional) [detector geometry description: xml/pndr]" << std::endl
+              << "    -e EventFileList       (optional) [colon-separated list of files: xml/pndr/pndz, pndz decompressed to TMPDIR]" << std::endl
+              << "    -g GeometryFile        (optional) [detector geometry description: xml/pndr/binary]" << std::endl
               << "    -n NEventsToProcess    (optional) [no. of events to process]" << std::endl
-              << "    -s NEventsToSkip       (optional) [no. of events to skip in first file]" << std::endl
+              << "    -s NEventsToSkip       (optional) [no. of events to skip in first file; seeks directly for an indexed pndr file]" << std::endl
+              << "    -L EventList           (optional) [comma-separated events or ranges to process from a single pndr file, e.g. 3,10-12]" << std::endl
+              << "    -t NThreads            (optional) [no. of event-parallel threads, each given a disjoint block of files or events]" << std::endl
+              << "    -f PrefetchDepth       (optional) [no. of pndr events to read ahead of reconstruction on a background thread]" << std::endl
+              << "    -M MemoryBudget        (optional) [MB of resident memory growth per event, beyond which the event is skipped and reset; single-threaded only]" << std::endl
+              << "    -T EventTimeLimit      (optional) [s of wall time per event, beyond which the event is skipped at the next algorithm boundary]"
+              << std::endl
+              << "    -H EventHardTimeLimit  (optional) [s of wall time per event, beyond which the job is ended; default twice EventTimeLimit]"
+              << std::endl
+              << "    -C CheckpointFile      (optional) [record the job's progress and written pndr event counts after each event]" << std::endl
+              << "    -R                     (optional) [resume from the checkpoint file, if present, truncating written pndr files to match]" << std::endl
+              << "    -o PfoFile             (optional) [write the RecreatedPfos hierarchy of each event to a memory-mappable columnar file]" << std::endl
+              << "    -D DaemonSocket        (optional) [serve jobs on a unix socket; each job is one line, e.g. \"-r Full -e file.pndr -n 10 -s 0\","
+              << " or \"shutdown\"]" << std::endl
+              << "    -P ProfilingFile       (optional) [write per-algorithm wall time, calls and allocations: json/csv]" << std::endl
+              << "    -E                     (optional) [include a per-event breakdown in the profiling file]" << std::endl
+              << "    -l EventLogFile        (optional) [write per-event wall time, peak resident memory, allocations and filtered hits: csv]" << std::endl
               << "    -p                     (optional) [print status]" << std::endl
               << "    -N                     (optional) [print event numbers]" << std::endl << std::endl;
 
@@ -190,6 +1386,9 @@ bool ProcessRecoOption(const std::string &recoOption, Parameters &parameters)
     std::string chosenRecoOption(recoOption);
     std::transform(chosenRecoOption.begin(), chosenRecoOption.end(), chosenRecoOption.begin(), ::tolower);
 
+    // ATTN In adaptive mode, the steering flags are instead taken from the settings of each LArMaster
+    parameters.m_shouldUseAdaptiveSteering = ("adaptive" == chosenRecoOption);
+
     if ("full" == chosenRecoOption)
     {
         parameters.m_shouldRunAllHitsCosmicReco = true;
@@ -270,7 +1469,7 @@ bool ProcessRecoOption(const std::string &recoOption, Parameters &parameters)
         parameters.m_shouldRunCosmicRecoOption = false;
         parameters.m_shouldPerformSliceId = false;
     }
-    else
+    else if (!parameters.m_shouldUseAdaptiveSteering)
     {
         std::cout << "LArReco, Unrecognized reconstruction option: " << recoOption << std::endl << std::endl;
         return PrintOptions();
@@ -289,6 +1488,10 @@ void ProcessExternalParameters(const Parameters &parameters, const Pandora *cons
     if (parameters.m_nEventsToSkip.IsInitialized()) pEventReadingParameters->m_skipToEvent = parameters.m_nEventsToSkip.Get();
     PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::SetExternalParameters(*pPandora, "LArEventReading", pEventReadingParameters));
 
+    // ATTN External parameters apply to every algorithm of a type, so would override the steering that distinguishes the adaptive paths
+    if (parameters.m_shouldUseAdaptiveSteering)
+        return;
+
     auto *const pEventSteeringParameters = new lar_content::MasterAlgorithm::ExternalSteeringParameters;
     pEventSteeringParameters->m_shouldRunAllHitsCosmicReco = parameters.m_shouldRunAllHitsCosmicReco;
     pEventSteeringParameters->m_shouldRunStitching = parameters.m_shouldRunStitching;
@@ -300,6 +1503,13 @@ void ProcessExternalParameters(const Parameters &parameters, const Pandora *cons
     pEventSteeringParameters->m_printOverallRecoStatus = parameters.m_printOverallRecoStatus;
     PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::SetExternalParameters(*pPandora, "LArMaster", pEventSteeringParameters));
 
+    if (ShouldWrapAlgorithms(parameters))
+    {
+        auto *const pProfilingSteeringParameters = new lar_content::MasterAlgorithm::ExternalSteeringParameters(*pEventSteeringParameters);
+        PANDORA_THROW_RESULT_IF(STATUS_CODE_SUCCESS, !=, PandoraApi::SetExternalParameters(*pPandora, "LArRecoProfilingMaster",
+            pProfilingSteeringParameters));
+    }
+
 #ifdef LIBTORCH_DL
     auto *const pEventSettingsParametersCopy = new lar_content::MasterAlgorithm::ExternalSteeringParameters(*pEventSteeringParameters);
     PANDORA_THROW_RESULT_IF(pandora::STATUS_CODE_SUCCESS, !=, pandora::ExternallyConfiguredAlgorithm::SetExternalParameters(*pPandora,
@@ -0,0 +1,80 @@
+/**
+ *  @file   LArReco/tools/EventCompressor.cxx
+ *
+ *  @brief  Conversion between binary (.pndr) event files and block-compressed (.pndz) event files
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/StatusCodes.h"
+
+#include "CompressedEventFile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <getopt.h>
+#include <iostream>
+#include <thread>
+
+using namespace pandora;
+using namespace lar_reco;
+
+int main(int argc, char *argv[])
+{
+    int c(0), compressionLevel(3);
+    bool shouldDecompress(false);
+
+    while ((c = getopt(argc, argv, "l:dh")) != -1)
+    {
+        switch (c)
+        {
+        case 'l':
+            compressionLevel = atoi(optarg);
+            break;
+        case 'd':
+            shouldDecompress = true;
+            break;
+        case 'h':
+        default:
+            optind = argc + 1;
+            break;
+        }
+    }
+
+    if (argc - optind != 2)
+    {
+        std::cout << std::endl << "./bin/LArEventCompressor [-l CompressionLevel] [-d] InputFile OutputFile" << std::endl
+                  << "    -l CompressionLevel    (optional) [zstd compression level, default 3]" << std::endl
+                  << "    -d                     (optional) [decompress a pndz file, rather than compress a pndr file]" << std::endl
+                  << "    InputFile              (required) [event file: pndr, or pndz with -d]" << std::endl
+                  << "    OutputFile             (required) [event file: pndz, accepted by PandoraInterface -e, or pndr with -d]" << std::endl << std::endl;
+        return 1;
+    }
+
+    const std::string inputFileName(argv[optind]), outputFileName(argv[optind + 1]);
+
+    try
+    {
+        if (shouldDecompress)
+        {
+            CompressedEventFile::BlockList blockList;
+            CompressedEventFile::ReadBlocks(inputFileName, blockList);
+            CompressedEventFile::Decompress(inputFileName, blockList, outputFileName, std::max(1U, std::thread::hardware_concurrency()));
+        }
+        else
+        {
+            CompressedEventFile::Compress(inputFileName, outputFileName, compressionLevel);
+
+            // Check that the output can be read
+            CompressedEventFile::BlockList blockList;
+            CompressedEventFile::ReadBlocks(outputFileName, blockList);
+        }
+    }
+    catch (const StatusCodeException &statusCodeException)
+    {
+        std::cerr << "Pandora StatusCodeException: " << statusCodeException.ToString() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+/**
+ *  @file   LArReco/tools/EventIndexer.cxx
+ *
+ *  @brief  Creation of index sidecars for binary pandora event files, enabling direct seeks to any event
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/StatusCodes.h"
+
+#include "EventFileHelper.h"
+
+#include <iostream>
+
+using namespace pandora;
+using namespace lar_reco;
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << std::endl << "./bin/LArEventIndexer EventFile [EventFile ...]" << std::endl
+                  << "    EventFile              (required) [binary event file: pndr; the index is written alongside, as pndr.idx]" << std::endl << std::endl;
+        return 1;
+    }
+
+    int errorNo(0);
+
+    for (int iFile = 1; iFile < argc; ++iFile)
+    {
+        const std::string eventFileName(argv[iFile]);
+
+        if (!EventFileHelper::IsBinaryFile(eventFileName))
+        {
+            std::cout << "LArEventIndexer, not a binary event file: " << eventFileName << std::endl;
+            errorNo = 1;
+            continue;
+        }
+
+        try
+        {
+            const unsigned int nEvents(EventFileHelper::WriteIndex(eventFileName));
+            std::cout << "LArEventIndexer, indexed " << nEvents << " events in " << eventFileName << std::endl;
+        }
+        catch (const StatusCodeException &statusCodeException)
+        {
+            std::cerr << "Pandora StatusCodeException: " << statusCodeException.ToString() << std::endl;
+            errorNo = 1;
+        }
+    }
+
+    return errorNo;
+}
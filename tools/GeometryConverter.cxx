@@ -0,0 +1,42 @@
+/**
+ *  @file   LArReco/tools/GeometryConverter.cxx
+ *
+ *  @brief  Conversion of xml geometry descriptions to the compact, memory-mappable binary geometry format
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/StatusCodes.h"
+
+#include "BinaryGeometry.h"
+
+#include <iostream>
+
+using namespace pandora;
+using namespace lar_reco;
+
+int main(int argc, char *argv[])
+{
+    if (3 != argc)
+    {
+        std::cout << std::endl << "./bin/LArGeometryConverter InputGeometryFile OutputGeometryFile" << std::endl
+                  << "    InputGeometryFile      (required) [detector geometry description: xml]" << std::endl
+                  << "    OutputGeometryFile     (required) [binary geometry, accepted by PandoraInterface -g]" << std::endl << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        BinaryGeometry::ConvertXmlGeometry(argv[1], argv[2]);
+
+        // Check that the output can be mapped and validated
+        const BinaryGeometry binaryGeometry(argv[2]);
+    }
+    catch (const StatusCodeException &statusCodeException)
+    {
+        std::cerr << "Pandora StatusCodeException: " << statusCodeException.ToString() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
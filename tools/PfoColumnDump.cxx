@@ -0,0 +1,74 @@
+/**
+ *  @file   LArReco/tools/PfoColumnDump.cxx
+ *
+ *  @brief  Summary of columnar pfo files, listing their columns and timing a scan of each column's values
+ *
+ *  $Log: $
+ */
+
+#include "Pandora/StatusCodes.h"
+
+#include "PfoColumnFile.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+using namespace pandora;
+using namespace lar_reco;
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << std::endl << "./bin/LArPfoColumnDump PfoFile [PfoFile ...]" << std::endl
+                  << "    PfoFile                (required) [columnar pfo file, as written by PandoraInterface -o]" << std::endl << std::endl;
+        return 1;
+    }
+
+    int errorNo(0);
+
+    for (int iFile = 1; iFile < argc; ++iFile)
+    {
+        try
+        {
+            const PfoColumnFile pfoColumnFile(argv[iFile]);
+
+            std::size_t nEvents(0), nPfos(0), nHits(0);
+            (void)pfoColumnFile.GetColumn<std::int32_t>("EventNumber", nEvents);
+            (void)pfoColumnFile.GetColumn<std::int32_t>("PfoPdgCode", nPfos);
+            (void)pfoColumnFile.GetColumn<std::uint8_t>("HitType", nHits);
+
+            std::cout << "LArPfoColumnDump, " << argv[iFile] << ": " << nEvents << " events, " << nPfos << " pfos, " << nHits << " hits" << std::endl;
+
+            for (unsigned int iColumn = 0; iColumn < pfoColumnFile.GetNumberOfColumns(); ++iColumn)
+            {
+                const PfoColumnFile::ColumnRecord &columnRecord(pfoColumnFile.GetColumnRecord(iColumn));
+                const unsigned char *const pBytes(pfoColumnFile.GetColumnBytes(iColumn));
+                const std::uint64_t nBytes(columnRecord.m_nElements * columnRecord.m_elementSize);
+
+                // ATTN Summing the bytes touches every page of the column, so the scan includes reading the column from disk if not cached
+                const auto startTime(std::chrono::steady_clock::now());
+                std::uint64_t checksum(0);
+
+                for (std::uint64_t iByte = 0; iByte < nBytes; ++iByte)
+                    checksum += pBytes[iByte];
+
+                const std::chrono::duration<double> scanTime(std::chrono::steady_clock::now() - startTime);
+
+                std::cout << "    " << std::left << std::setw(20) << columnRecord.m_name << std::right << std::setw(12) << columnRecord.m_nElements
+                          << " x " << columnRecord.m_elementSize << " bytes, scanned at " << std::fixed << std::setprecision(1)
+                          << ((scanTime.count() > 0.) ? nBytes / scanTime.count() / (1 << 20) : 0.) << " MB/s (checksum " << checksum << ")"
+                          << std::defaultfloat << std::endl;
+            }
+        }
+        catch (const StatusCodeException &statusCodeException)
+        {
+            std::cerr << "Pandora StatusCodeException: " << statusCodeException.ToString() << std::endl;
+            errorNo = 1;
+        }
+    }
+
+    return errorNo;
+}
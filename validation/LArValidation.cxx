@@ -0,0 +1,190 @@
+/**
+ *  @file   LArReco/validation/LArValidation.cxx
+ *
+ *  @brief  Standalone, compiled validation executable, running the validation functionality over the Validation trees in a list of files
+ *
+ *  $Log: $
+ */
+#include "TFile.h"
+
+// ATTN The validation functionality is written as a ROOT macro, with definitions in its header, so is compiled here as a single unit
+#include "Validation.C"
+
+#include <cstdlib>
+#include <getopt.h>
+
+/**
+ *  @brief  Parse the command line arguments, setting the application parameters
+ *
+ *  @param  argc argument count
+ *  @param  argv argument vector
+ *  @param  inputFilesList to receive the list of input file regexes
+ *  @param  histogramFileName to receive the name of the file to which to write histograms
+ *  @param  parameters to receive the application parameters
+ *
+ *  @return success
+ */
+bool ParseCommandLine(int argc, char *argv[], std::vector<std::string> &inputFilesList, std::string &histogramFileName, Parameters &parameters);
+
+/**
+ *  @brief  Print the list of configurable options
+ *
+ *  @return false, to force abort
+ */
+bool PrintOptions();
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+    try
+    {
+        std::vector<std::string> inputFilesList;
+        std::string histogramFileName;
+        Parameters parameters;
+
+        if (!ParseCommandLine(argc, argv, inputFilesList, histogramFileName, parameters))
+            return 1;
+
+        // ATTN Histograms are created in the current directory, so are written to the histogram file if one is open
+        TFile *const pTFile(histogramFileName.empty() ? nullptr : TFile::Open(histogramFileName.c_str(), "RECREATE"));
+
+        if (!histogramFileName.empty() && (!pTFile || pTFile->IsZombie()))
+        {
+            std::cout << "LArValidation, unable to open histogram file " << histogramFileName << std::endl;
+            return 1;
+        }
+
+        Validation(inputFilesList, parameters);
+
+        if (pTFile)
+        {
+            pTFile->Write();
+            pTFile->Close();
+            delete pTFile;
+        }
+    }
+    catch (const std::exception &exception)
+    {
+        std::cout << "LArValidation, exception: " << exception.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool ParseCommandLine(int argc, char *argv[], std::vector<std::string> &inputFilesList, std::string &histogramFileName, Parameters &parameters)
+{
+    if (1 == argc)
+        return PrintOptions();
+
+    // ATTN Displaying the matches for every event is opt-in for the executable, unlike the macro
+    parameters.m_displayMatchedEvents = false;
+
+    int c(0);
+    std::string fiducialCut;
+
+    while ((c = getopt(argc, argv, "i:n:s:f:cx:bBo:p:m:e:t:dh")) != -1)
+    {
+        switch (c)
+        {
+        case 'i':
+            inputFilesList.push_back(optarg);
+            break;
+        case 'n':
+            parameters.m_nEventsToProcess = atoi(optarg);
+            break;
+        case 's':
+            parameters.m_skipEvents = atoi(optarg);
+            break;
+        case 'f':
+            fiducialCut = optarg;
+            break;
+        case 'c':
+            parameters.m_correctTrackShowerId = true;
+            break;
+        case 'x':
+            parameters.m_vertexXCorrection = atof(optarg);
+            break;
+        case 'b':
+            parameters.m_testBeamMode = true;
+            break;
+        case 'B':
+            parameters.m_triggeredBeamOnly = false;
+            break;
+        case 'o':
+            histogramFileName = optarg;
+            parameters.m_histogramOutput = true;
+            break;
+        case 'p':
+            parameters.m_histPrefix = optarg;
+            break;
+        case 'm':
+            parameters.m_mapFileName = optarg;
+            break;
+        case 'e':
+            parameters.m_eventFileName = optarg;
+            break;
+        case 't':
+            parameters.m_nThreads = atoi(optarg);
+            break;
+        case 'd':
+            parameters.m_displayMatchedEvents = true;
+            break;
+        case 'h':
+        default:
+            return PrintOptions();
+        }
+    }
+
+    // Remaining arguments are also taken as input file regexes, so a shell-expanded file list may be given directly
+    for (int iArg = optind; iArg < argc; ++iArg)
+        inputFilesList.push_back(argv[iArg]);
+
+    if (inputFilesList.empty())
+    {
+        std::cout << "LArValidation, no input files specified" << std::endl;
+        return PrintOptions();
+    }
+
+    if ("uboone" == fiducialCut)
+    {
+        parameters.m_applyUbooneFiducialCut = true;
+    }
+    else if ("sbnd" == fiducialCut)
+    {
+        parameters.m_applySBNDFiducialCut = true;
+    }
+    else if (!fiducialCut.empty())
+    {
+        std::cout << "LArValidation, unrecognised fiducial cut " << fiducialCut << std::endl;
+        return PrintOptions();
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+bool PrintOptions()
+{
+    std::cout << std::endl << "./bin/LArValidation [InputFiles ...]" << std::endl
+              << "    -i InputFiles          (required) [regex identifying input root files with Validation trees; may be repeated, or given as trailing arguments]" << std::endl
+              << "    -n NEventsToProcess    (optional) [no. of events to process]" << std::endl
+              << "    -s NEventsToSkip       (optional) [no. of events to skip]" << std::endl
+              << "    -f FiducialCut         (optional) [fiducial volume cut applied to true neutrino vertices: uboone, sbnd]" << std::endl
+              << "    -c                     (optional) [demand that pfos are correctly flagged as tracks or showers]" << std::endl
+              << "    -x VertexXCorrection   (optional) [cm added to the true vertex x position, default 0.495694]" << std::endl
+              << "    -b                     (optional) [test beam mode]" << std::endl
+              << "    -B                     (optional) [consider untriggered, as well as triggered, beam particles]" << std::endl
+              << "    -o HistogramFile       (optional) [write histograms to a root file]" << std::endl
+              << "    -p HistogramPrefix     (optional) [prefix for histogram names]" << std::endl
+              << "    -m MapFile             (optional) [append output ascii tables to a file]" << std::endl
+              << "    -e EventFile           (optional) [append list of correct events to a file]" << std::endl
+              << "    -t NThreads            (optional) [no. of worker threads, each validating whole input files]" << std::endl
+              << "    -d                     (optional) [display matching results for individual events]" << std::endl << std::endl;
+
+    return false;
+}
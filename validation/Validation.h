@@ -8,7 +8,11 @@
 #ifndef NEW_LAR_VALIDATION_H
 #define NEW_LAR_VALIDATION_H 1
 
+#include <array>
 #include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 typedef std::vector<int> IntVector;
 typedef std::vector<float> FloatVector;
@@ -37,6 +41,7 @@ public:
     std::string             m_histPrefix;               ///< Histogram name prefix
     std::string             m_mapFileName;              ///< File name to which to write output ascii tables, etc.
     std::string             m_eventFileName;            ///< File name to which to write list of correct events
+    int                     m_nThreads;                 ///< The number of worker threads, each validating whole input files (1 for serial processing)
 };
 
 //------------------------------------------------------------------------------------------------------------------------------------------
@@ -87,95 +92,100 @@ SimpleThreeVector operator+(const SimpleThreeVector &lhs, const SimpleThreeVecto
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 /**
- *  @brief SimpleMCPrimary class
+ *  @brief  SimpleMCPrimaryColumns class, the mc primaries of an event, stored as one contiguous column per quantity
  */
-class SimpleMCPrimary
+class SimpleMCPrimaryColumns
 {
 public:
     /**
-     *  @brief  Constructor
+     *  @brief  Clear the columns, retaining their capacity for the next event
      */
-    SimpleMCPrimary();
-
-    int                 m_primaryId;                    ///< The identifier
-    int                 m_pdgCode;                      ///< The pdg code
-    float               m_energy;                       ///< The energy
-    SimpleThreeVector   m_momentum;                     ///< The momentum
-    SimpleThreeVector   m_vertex;                       ///< The vertex
-    SimpleThreeVector   m_endpoint;                     ///< The endpoint
-    int                 m_nMCHitsTotal;                 ///< The total number of mc hits
-    int                 m_nMCHitsU;                     ///< The number of u mc hits
-    int                 m_nMCHitsV;                     ///< The number of v mc hits
-    int                 m_nMCHitsW;                     ///< The number of w mc hits
-
-    int                 m_nPrimaryMatchedPfos;          ///< The number of matched pfos
-    int                 m_nPrimaryMatchedNuPfos;        ///< The number of matched nu pfos
-    int                 m_nPrimaryMatchedCRPfos;        ///< The number of matched cr pfos
-    int                 m_bestMatchPfoId;               ///< The best match pfo identifier
-    int                 m_bestMatchPfoPdgCode;          ///< The best match pfo pdg code
-    int                 m_bestMatchPfoIsRecoNu;         ///< Whether best match pfo is reconstructed as part of a neutrino hierarchy
-    int                 m_bestMatchPfoRecoNuId;         ///< The identifier of the associated reco neutrino (if part of a neutrino hierarchy)
-    int                 m_bestMatchPfoIsTestBeam;       ///< Whether best match pfo is reconstructed as a test beam particle
-    int                 m_bestMatchPfoNHitsTotal;       ///< The best match pfo total number of pfo hits
-    int                 m_bestMatchPfoNHitsU;           ///< The best match pfo number of u pfo hits
-    int                 m_bestMatchPfoNHitsV;           ///< The best match pfo number of v pfo hits
-    int                 m_bestMatchPfoNHitsW;           ///< The best match pfo number of w pfo hits
-    int                 m_bestMatchPfoNSharedHitsTotal; ///< The best match pfo total number of matched hits
-    int                 m_bestMatchPfoNSharedHitsU;     ///< The best match pfo number of u matched hits
-    int                 m_bestMatchPfoNSharedHitsV;     ///< The best match pfo number of v matched hits
-    int                 m_bestMatchPfoNSharedHitsW;     ///< The best match pfo number of w matched hits
+    void Clear();
+
+    IntVector           m_primaryId;                    ///< The identifiers
+    IntVector           m_pdgCode;                      ///< The pdg codes
+    FloatVector         m_energy;                       ///< The energies
+    FloatVector         m_momentumX;                    ///< The momentum x values
+    FloatVector         m_momentumY;                    ///< The momentum y values
+    FloatVector         m_momentumZ;                    ///< The momentum z values
+    FloatVector         m_vertexX;                      ///< The vertex x values
+    FloatVector         m_vertexY;                      ///< The vertex y values
+    FloatVector         m_vertexZ;                      ///< The vertex z values
+    FloatVector         m_endpointX;                    ///< The endpoint x values
+    FloatVector         m_endpointY;                    ///< The endpoint y values
+    FloatVector         m_endpointZ;                    ///< The endpoint z values
+    IntVector           m_nMCHitsTotal;                 ///< The total numbers of mc hits
+    IntVector           m_nMCHitsU;                     ///< The numbers of u mc hits
+    IntVector           m_nMCHitsV;                     ///< The numbers of v mc hits
+    IntVector           m_nMCHitsW;                     ///< The numbers of w mc hits
+
+    IntVector           m_nPrimaryMatchedPfos;          ///< The numbers of matched pfos
+    IntVector           m_nPrimaryMatchedNuPfos;        ///< The numbers of matched nu pfos
+    IntVector           m_nPrimaryMatchedCRPfos;        ///< The numbers of matched cr pfos
+    IntVector           m_bestMatchPfoId;               ///< The best match pfo identifiers
+    IntVector           m_bestMatchPfoPdgCode;          ///< The best match pfo pdg codes
+    IntVector           m_bestMatchPfoIsRecoNu;         ///< Whether best match pfos are reconstructed as part of a neutrino hierarchy
+    IntVector           m_bestMatchPfoRecoNuId;         ///< The identifiers of the associated reco neutrinos (if part of a neutrino hierarchy)
+    IntVector           m_bestMatchPfoIsTestBeam;       ///< Whether best match pfos are reconstructed as test beam particles
+    IntVector           m_bestMatchPfoNHitsTotal;       ///< The best match pfo total numbers of pfo hits
+    IntVector           m_bestMatchPfoNHitsU;           ///< The best match pfo numbers of u pfo hits
+    IntVector           m_bestMatchPfoNHitsV;           ///< The best match pfo numbers of v pfo hits
+    IntVector           m_bestMatchPfoNHitsW;           ///< The best match pfo numbers of w pfo hits
+    IntVector           m_bestMatchPfoNSharedHitsTotal; ///< The best match pfo total numbers of matched hits
+    IntVector           m_bestMatchPfoNSharedHitsU;     ///< The best match pfo numbers of u matched hits
+    IntVector           m_bestMatchPfoNSharedHitsV;     ///< The best match pfo numbers of v matched hits
+    IntVector           m_bestMatchPfoNSharedHitsW;     ///< The best match pfo numbers of w matched hits
 };
 
-typedef std::vector<SimpleMCPrimary> SimpleMCPrimaryList;
-
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 /**
- *  @brief SimpleMCTarget class
+ *  @brief  SimpleMCTargetColumns class, the mc targets of an event, stored as one contiguous column per quantity
  */
-class SimpleMCTarget
+class SimpleMCTargetColumns
 {
 public:
     /**
-     *  @brief  Constructor
+     *  @brief  Clear the columns, retaining their capacity for the next event
      */
-    SimpleMCTarget();
-
-    int                 m_interactionType;              ///< The target interaction type
-    int                 m_mcNuanceCode;                 ///< The target nuance code
-    int                 m_isNeutrino;                   ///< Whether the target is a neutrino
-    int                 m_isBeamParticle;               ///< Whether the target is a beam particle
-    int                 m_isCosmicRay;                  ///< Whether the target is a cosmic ray
-
-    SimpleThreeVector   m_targetVertex;                 ///< The target vertex position
-    SimpleThreeVector   m_recoVertex;                   ///< The reco vertex position, if available
-
-    int                 m_isCorrectNu;                  ///< Whether the target was correctly reconstructed as a neutrino
-    int                 m_isCorrectTB;                  ///< Whether the target was correctly reconstructed as a beam particle
-    int                 m_isCorrectCR;                  ///< Whether the target was correctly reconstructed as a cosmic ray
-    int                 m_isFakeNu;                     ///< Whether the target was reconstructed as a fake neutrino
-    int                 m_isFakeCR;                     ///< Whether the target was reconstructed as a fake cosmic ray
-    int                 m_isSplitNu;                    ///< Whether the target was reconstructed as a split neutrino
-    int                 m_isSplitCR;                    ///< Whether the target was reconstructed as a split cosmic ray
-    int                 m_isLost;                       ///< Whether the target was lost (not reconstructed)
-
-    int                 m_nTargetMatches;               ///< The number of pfo matches to the target
-    int                 m_nTargetNuMatches;             ///< The number of neutrino pfo matches to the target
-    int                 m_nTargetCRMatches;             ///< The number of cosmic ray pfo matches to the target
-    int                 m_nTargetGoodNuMatches;         ///< The number of good neutrino pfo matches to the target (all from same parent neutrino)
-    int                 m_nTargetNuSplits;              ///< The number of split neutrino pfo matches to the target (from different parent neutrinos)
-    int                 m_nTargetNuLosses;              ///< The number of neutrino primaries with no matches
-
-    int                 m_nTargetPrimaries;             ///< The number of target mc primaries
-    SimpleMCPrimaryList m_mcPrimaryList;                ///< The list of mc primaries
+    void Clear();
+
+    IntVector           m_interactionType;              ///< The target interaction types
+    IntVector           m_mcNuanceCode;                 ///< The target nuance codes
+    IntVector           m_isNeutrino;                   ///< Whether the targets are neutrinos
+    IntVector           m_isBeamParticle;               ///< Whether the targets are beam particles
+    IntVector           m_isCosmicRay;                  ///< Whether the targets are cosmic rays
+
+    FloatVector         m_targetVertexX;                ///< The target vertex x positions
+    FloatVector         m_targetVertexY;                ///< The target vertex y positions
+    FloatVector         m_targetVertexZ;                ///< The target vertex z positions
+    FloatVector         m_recoVertexX;                  ///< The reco vertex x positions, if available
+    FloatVector         m_recoVertexY;                  ///< The reco vertex y positions, if available
+    FloatVector         m_recoVertexZ;                  ///< The reco vertex z positions, if available
+
+    IntVector           m_isCorrectNu;                  ///< Whether the targets were correctly reconstructed as neutrinos
+    IntVector           m_isCorrectTB;                  ///< Whether the targets were correctly reconstructed as beam particles
+    IntVector           m_isCorrectCR;                  ///< Whether the targets were correctly reconstructed as cosmic rays
+    IntVector           m_isFakeNu;                     ///< Whether the targets were reconstructed as fake neutrinos
+    IntVector           m_isFakeCR;                     ///< Whether the targets were reconstructed as fake cosmic rays
+    IntVector           m_isSplitNu;                    ///< Whether the targets were reconstructed as split neutrinos
+    IntVector           m_isSplitCR;                    ///< Whether the targets were reconstructed as split cosmic rays
+    IntVector           m_isLost;                       ///< Whether the targets were lost (not reconstructed)
+
+    IntVector           m_nTargetMatches;               ///< The numbers of pfo matches to the targets
+    IntVector           m_nTargetNuMatches;             ///< The numbers of neutrino pfo matches to the targets
+    IntVector           m_nTargetCRMatches;             ///< The numbers of cosmic ray pfo matches to the targets
+    IntVector           m_nTargetGoodNuMatches;         ///< The numbers of good neutrino pfo matches to the targets (all from same parent neutrino)
+    IntVector           m_nTargetNuSplits;              ///< The numbers of split neutrino pfo matches to the targets (from different parent neutrinos)
+    IntVector           m_nTargetNuLosses;              ///< The numbers of neutrino primaries with no matches
+
+    IntVector           m_primaryBegin;                 ///< The primaries of target i are [m_primaryBegin[i], m_primaryBegin[i + 1]), so one entry per target plus one
 };
 
-typedef std::vector<SimpleMCTarget> SimpleMCTargetList;
-
 //------------------------------------------------------------------------------------------------------------------------------------------
 
 /**
- *  @brief SimpleMCEvent class
+ *  @brief  SimpleMCEvent class, a flat structure of arrays, with the primaries of each target held contiguously, in the order of the targets
  */
 class SimpleMCEvent
 {
@@ -185,41 +195,245 @@ public:
      */
     SimpleMCEvent();
 
-    int                 m_fileIdentifier;               ///< The file identifier
-    int                 m_eventNumber;                  ///< The event number
+    /**
+     *  @brief  Clear the event, retaining the capacity of its columns for the next event
+     */
+    void Clear();
+
+    int                     m_fileIdentifier;           ///< The file identifier
+    int                     m_eventNumber;              ///< The event number
 
-    int                 m_nMCTargets;                   ///< The number of mc targets
-    SimpleMCTargetList  m_mcTargetList;                 ///< The list of mc targets
+    int                     m_nMCTargets;               ///< The number of mc targets
+    SimpleMCTargetColumns   m_targets;                  ///< The mc target columns
+    SimpleMCPrimaryColumns  m_primaries;                ///< The mc primary columns
 };
 
-typedef std::vector<SimpleMCEvent> SimpleMCEventList;
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ *  @brief  MatchingColumns class, per-target and per-primary quantities derived from an event by column passes, reused across events
+ */
+class MatchingColumns
+{
+public:
+    IntVector           m_passFiducialCut;              ///< Whether each target passes the fiducial cut
+    IntVector           m_expectedPrimary;              ///< The expected primary corresponding to each primary
+    IntVector           m_isCorrectParticleId;          ///< Whether the best matched pfo of each primary has the correct particle id
+    FloatVector         m_bestMatchCompleteness;        ///< The completeness of the best matched pfo of each primary
+    FloatVector         m_bestMatchPurity;              ///< The purity of the best matched pfo of each primary
+    FloatVector         m_trueMomentum;                 ///< The true momentum of each primary
+};
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+class TChain;
+
+/**
+ *  @brief  ValidationTreeReader class, reading simple mc events from a chain of validation trees. Branches are bound once, only the branches
+ *          required by the analysis are enabled and they are read ahead in bulk via the tree cache.
+ */
+class ValidationTreeReader
+{
+public:
+    /**
+     *  @brief  Constructor
+     *
+     *  @param  pTChain the address of the chain
+     *  @param  parameters the parameters
+     */
+    ValidationTreeReader(TChain *const pTChain, const Parameters &parameters);
+
+    /**
+     *  @brief  Destructor
+     */
+    ~ValidationTreeReader();
+
+    /**
+     *  @brief  Deleted copy constructor, as the chain is bound to the reader's members
+     */
+    ValidationTreeReader(const ValidationTreeReader &) = delete;
+
+    /**
+     *  @brief  Deleted assignment operator
+     */
+    ValidationTreeReader &operator=(const ValidationTreeReader &) = delete;
+
+    /**
+     *  @brief  Read the next event from the chain, comprising the consecutive chain entries (targets) with the same event number
+     *
+     *  @param  simpleMCEvent the event to be populated
+     *
+     *  @return whether an event was read
+     */
+    bool ReadNextEvent(SimpleMCEvent &simpleMCEvent);
+
+    /**
+     *  @brief  Get the number of chain entries read
+     *
+     *  @return the number of chain entries read
+     */
+    long long GetNEntriesRead() const;
+
+private:
+    /**
+     *  @brief  Enable a branch, bind it to the provided address and add it to the tree cache
+     *
+     *  @param  branchName the branch name
+     *  @param  pAddress the address to which to bind the branch
+     */
+    void EnableBranch(const std::string &branchName, void *const pAddress);
+
+    /**
+     *  @brief  Read a chain entry into the bound addresses, if not already read
+     *
+     *  @param  iEntry the chain entry
+     */
+    void ReadEntry(const long long iEntry);
+
+    /**
+     *  @brief  Append the target and mc primaries of the current chain entry to the columns of a simple mc event
+     *
+     *  @param  simpleMCEvent the simple mc event
+     */
+    void AppendTarget(SimpleMCEvent &simpleMCEvent) const;
+
+    /**
+     *  @brief  Append the values of a primary branch to a column, or default values if the branch is not read
+     *
+     *  @param  pBranchValues the address of the branch values, nullptr if the branch is not read
+     *  @param  nPrimaries the number of primaries
+     *  @param  defaultValue the default value
+     *  @param  column the column
+     */
+    template <typename T>
+    static void AppendColumn(const std::vector<T> *const pBranchValues, const int nPrimaries, const T defaultValue, std::vector<T> &column);
+
+    /**
+     *  @brief  TargetEntry class, the target quantities of a single chain entry, to which the target branches are bound
+     */
+    class TargetEntry
+    {
+    public:
+        /**
+         *  @brief  Constructor
+         */
+        TargetEntry();
+
+        int                 m_interactionType;          ///< The target interaction type
+        int                 m_mcNuanceCode;             ///< The target nuance code
+        int                 m_isNeutrino;               ///< Whether the target is a neutrino
+        int                 m_isBeamParticle;           ///< Whether the target is a beam particle
+        int                 m_isCosmicRay;              ///< Whether the target is a cosmic ray
+        SimpleThreeVector   m_targetVertex;             ///< The target vertex position
+        SimpleThreeVector   m_recoVertex;               ///< The reco vertex position, if available
+        int                 m_isCorrectNu;              ///< Whether the target was correctly reconstructed as a neutrino
+        int                 m_isCorrectTB;              ///< Whether the target was correctly reconstructed as a beam particle
+        int                 m_isCorrectCR;              ///< Whether the target was correctly reconstructed as a cosmic ray
+        int                 m_isFakeNu;                 ///< Whether the target was reconstructed as a fake neutrino
+        int                 m_isFakeCR;                 ///< Whether the target was reconstructed as a fake cosmic ray
+        int                 m_isSplitNu;                ///< Whether the target was reconstructed as a split neutrino
+        int                 m_isSplitCR;                ///< Whether the target was reconstructed as a split cosmic ray
+        int                 m_isLost;                   ///< Whether the target was lost (not reconstructed)
+        int                 m_nTargetMatches;           ///< The number of pfo matches to the target
+        int                 m_nTargetNuMatches;         ///< The number of neutrino pfo matches to the target
+        int                 m_nTargetCRMatches;         ///< The number of cosmic ray pfo matches to the target
+        int                 m_nTargetGoodNuMatches;     ///< The number of good neutrino pfo matches to the target
+        int                 m_nTargetNuSplits;          ///< The number of split neutrino pfo matches to the target
+        int                 m_nTargetNuLosses;          ///< The number of neutrino primaries with no matches
+        int                 m_nTargetPrimaries;         ///< The number of target mc primaries
+    };
+
+    TChain                 *m_pTChain;                  ///< The address of the chain
+    bool                    m_testBeamMode;             ///< Whether running in test beam mode
+    bool                    m_readDisplayBranches;      ///< Whether to read the branches used only when displaying matched events
+    long long               m_nChainEntries;            ///< The number of chain entries
+    long long               m_iNextEntry;               ///< The first chain entry of the next event
+    long long               m_iReadEntry;               ///< The chain entry currently held in the bound addresses
+    long long               m_nEntriesRead;             ///< The number of chain entries read
+
+    int                     m_eventNumber;              ///< The event number of the current chain entry
+    int                     m_fileIdentifier;           ///< The file identifier of the current chain entry
+    TargetEntry             m_targetEntry;              ///< The target quantities of the current chain entry
+
+    IntVector              *m_pMCPrimaryId;             ///< The mc primary identifiers
+    IntVector              *m_pMCPrimaryPdg;            ///< The mc primary pdg codes
+    FloatVector            *m_pMCPrimaryE;              ///< The mc primary energies
+    FloatVector            *m_pMCPrimaryPX;             ///< The mc primary momentum x values
+    FloatVector            *m_pMCPrimaryPY;             ///< The mc primary momentum y values
+    FloatVector            *m_pMCPrimaryPZ;             ///< The mc primary momentum z values
+    FloatVector            *m_pMCPrimaryVtxX;           ///< The mc primary vertex x values
+    FloatVector            *m_pMCPrimaryVtxY;           ///< The mc primary vertex y values
+    FloatVector            *m_pMCPrimaryVtxZ;           ///< The mc primary vertex z values
+    FloatVector            *m_pMCPrimaryEndX;           ///< The mc primary endpoint x values
+    FloatVector            *m_pMCPrimaryEndY;           ///< The mc primary endpoint y values
+    FloatVector            *m_pMCPrimaryEndZ;           ///< The mc primary endpoint z values
+    IntVector              *m_pNMCHitsTotal;            ///< The mc primary total numbers of mc hits
+    IntVector              *m_pNMCHitsU;                ///< The mc primary numbers of u mc hits
+    IntVector              *m_pNMCHitsV;                ///< The mc primary numbers of v mc hits
+    IntVector              *m_pNMCHitsW;                ///< The mc primary numbers of w mc hits
+    IntVector              *m_pNPrimaryMatchedPfos;     ///< The mc primary numbers of matched pfos
+    IntVector              *m_pNPrimaryMatchedNuPfos;   ///< The mc primary numbers of matched nu pfos
+    IntVector              *m_pNPrimaryMatchedCRPfos;   ///< The mc primary numbers of matched cr pfos
+    IntVector              *m_pBestMatchPfoId;          ///< The best match pfo identifiers
+    IntVector              *m_pBestMatchPfoPdg;         ///< The best match pfo pdg codes
+    IntVector              *m_pBestMatchPfoIsRecoNu;    ///< Whether the best match pfos are reconstructed as part of a neutrino hierarchy
+    IntVector              *m_pBestMatchPfoRecoNuId;    ///< The identifiers of the reco neutrinos associated with the best match pfos
+    IntVector              *m_pBestMatchPfoIsTestBeam;  ///< Whether the best match pfos are reconstructed as test beam particles
+    IntVector              *m_pBestMatchPfoNHitsTotal;  ///< The best match pfo total numbers of pfo hits
+    IntVector              *m_pBestMatchPfoNHitsU;      ///< The best match pfo numbers of u pfo hits
+    IntVector              *m_pBestMatchPfoNHitsV;      ///< The best match pfo numbers of v pfo hits
+    IntVector              *m_pBestMatchPfoNHitsW;      ///< The best match pfo numbers of w pfo hits
+    IntVector              *m_pBestMatchPfoNSharedHitsTotal; ///< The best match pfo total numbers of matched hits
+    IntVector              *m_pBestMatchPfoNSharedHitsU;///< The best match pfo numbers of u matched hits
+    IntVector              *m_pBestMatchPfoNSharedHitsV;///< The best match pfo numbers of v matched hits
+    IntVector              *m_pBestMatchPfoNSharedHitsW;///< The best match pfo numbers of w matched hits
+
+    static const long long  m_treeCacheSize;            ///< The size of the tree cache, units bytes
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+#define GET_ENUM_ENTRY(a)                                                       \
+    a,
+
+#define GET_ENUM_NAME(a)                                                        \
+    #a,
+
+#define GET_ENUM_COUNT(a)                                                       \
+    + 1
+
+/**
+ *  @brief  The expected primary table, generating both the ExpectedPrimary enum and its compile-time name table
+ */
+#define EXPECTED_PRIMARY_TABLE(d)    \
+    d(MUON)                          \
+    d(ELECTRON)                      \
+    d(PROTON1)                       \
+    d(PROTON2)                       \
+    d(PROTON3)                       \
+    d(PROTON4)                       \
+    d(PROTON5)                       \
+    d(PIPLUS)                        \
+    d(PIMINUS)                       \
+    d(NEUTRON)                       \
+    d(PHOTON1)                       \
+    d(PHOTON2)                       \
+    d(OTHER_PRIMARY)
+
 /**
  * @brief   ExpectedPrimary enum
  */
 enum ExpectedPrimary : int
 {
-    MUON,
-    ELECTRON,
-    PROTON1,
-    PROTON2,
-    PROTON3,
-    PROTON4,
-    PROTON5,
-    PIPLUS,
-    PIMINUS,
-    NEUTRON,
-    PHOTON1,
-    PHOTON2,
-    OTHER_PRIMARY
+    EXPECTED_PRIMARY_TABLE(GET_ENUM_ENTRY)
 };
 
+constexpr int N_EXPECTED_PRIMARIES(0 EXPECTED_PRIMARY_TABLE(GET_ENUM_COUNT));
+
 /**
- *  @brief  Get a string representation of an interaction type
+ *  @brief  Get a string representation of an expected primary
  *
- *  @param  interactionType the interaction type
+ *  @param  expectedPrimary the expected primary
  *
  *  @return string
  */
@@ -227,178 +441,186 @@ std::string ToString(const ExpectedPrimary expectedPrimary);
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+/**
+ *  @brief  The interaction type table, generating both the InteractionType enum and its compile-time name table
+ */
+#define INTERACTION_TYPE_TABLE(d)    \
+    d(CCQEL_MU)                      \
+    d(CCQEL_MU_P)                    \
+    d(CCQEL_MU_P_P)                  \
+    d(CCQEL_MU_P_P_P)                \
+    d(CCQEL_MU_P_P_P_P)              \
+    d(CCQEL_MU_P_P_P_P_P)            \
+    d(CCQEL_E)                       \
+    d(CCQEL_E_P)                     \
+    d(CCQEL_E_P_P)                   \
+    d(CCQEL_E_P_P_P)                 \
+    d(CCQEL_E_P_P_P_P)               \
+    d(CCQEL_E_P_P_P_P_P)             \
+    d(NCQEL_P)                       \
+    d(NCQEL_P_P)                     \
+    d(NCQEL_P_P_P)                   \
+    d(NCQEL_P_P_P_P)                 \
+    d(NCQEL_P_P_P_P_P)               \
+    d(CCRES_MU)                      \
+    d(CCRES_MU_P)                    \
+    d(CCRES_MU_P_P)                  \
+    d(CCRES_MU_P_P_P)                \
+    d(CCRES_MU_P_P_P_P)              \
+    d(CCRES_MU_P_P_P_P_P)            \
+    d(CCRES_MU_PIPLUS)               \
+    d(CCRES_MU_P_PIPLUS)             \
+    d(CCRES_MU_P_P_PIPLUS)           \
+    d(CCRES_MU_P_P_P_PIPLUS)         \
+    d(CCRES_MU_P_P_P_P_PIPLUS)       \
+    d(CCRES_MU_P_P_P_P_P_PIPLUS)     \
+    d(CCRES_MU_PHOTON)               \
+    d(CCRES_MU_P_PHOTON)             \
+    d(CCRES_MU_P_P_PHOTON)           \
+    d(CCRES_MU_P_P_P_PHOTON)         \
+    d(CCRES_MU_P_P_P_P_PHOTON)       \
+    d(CCRES_MU_P_P_P_P_P_PHOTON)     \
+    d(CCRES_MU_PIZERO)               \
+    d(CCRES_MU_P_PIZERO)             \
+    d(CCRES_MU_P_P_PIZERO)           \
+    d(CCRES_MU_P_P_P_PIZERO)         \
+    d(CCRES_MU_P_P_P_P_PIZERO)       \
+    d(CCRES_MU_P_P_P_P_P_PIZERO)     \
+    d(CCRES_E)                       \
+    d(CCRES_E_P)                     \
+    d(CCRES_E_P_P)                   \
+    d(CCRES_E_P_P_P)                 \
+    d(CCRES_E_P_P_P_P)               \
+    d(CCRES_E_P_P_P_P_P)             \
+    d(CCRES_E_PIPLUS)                \
+    d(CCRES_E_P_PIPLUS)              \
+    d(CCRES_E_P_P_PIPLUS)            \
+    d(CCRES_E_P_P_P_PIPLUS)          \
+    d(CCRES_E_P_P_P_P_PIPLUS)        \
+    d(CCRES_E_P_P_P_P_P_PIPLUS)      \
+    d(CCRES_E_PHOTON)                \
+    d(CCRES_E_P_PHOTON)              \
+    d(CCRES_E_P_P_PHOTON)            \
+    d(CCRES_E_P_P_P_PHOTON)          \
+    d(CCRES_E_P_P_P_P_PHOTON)        \
+    d(CCRES_E_P_P_P_P_P_PHOTON)      \
+    d(CCRES_E_PIZERO)                \
+    d(CCRES_E_P_PIZERO)              \
+    d(CCRES_E_P_P_PIZERO)            \
+    d(CCRES_E_P_P_P_PIZERO)          \
+    d(CCRES_E_P_P_P_P_PIZERO)        \
+    d(CCRES_E_P_P_P_P_P_PIZERO)      \
+    d(NCRES_P)                       \
+    d(NCRES_P_P)                     \
+    d(NCRES_P_P_P)                   \
+    d(NCRES_P_P_P_P)                 \
+    d(NCRES_P_P_P_P_P)               \
+    d(NCRES_PIPLUS)                  \
+    d(NCRES_P_PIPLUS)                \
+    d(NCRES_P_P_PIPLUS)              \
+    d(NCRES_P_P_P_PIPLUS)            \
+    d(NCRES_P_P_P_P_PIPLUS)          \
+    d(NCRES_P_P_P_P_P_PIPLUS)        \
+    d(NCRES_PIMINUS)                 \
+    d(NCRES_P_PIMINUS)               \
+    d(NCRES_P_P_PIMINUS)             \
+    d(NCRES_P_P_P_PIMINUS)           \
+    d(NCRES_P_P_P_P_PIMINUS)         \
+    d(NCRES_P_P_P_P_P_PIMINUS)       \
+    d(NCRES_PHOTON)                  \
+    d(NCRES_P_PHOTON)                \
+    d(NCRES_P_P_PHOTON)              \
+    d(NCRES_P_P_P_PHOTON)            \
+    d(NCRES_P_P_P_P_PHOTON)          \
+    d(NCRES_P_P_P_P_P_PHOTON)        \
+    d(NCRES_PIZERO)                  \
+    d(NCRES_P_PIZERO)                \
+    d(NCRES_P_P_PIZERO)              \
+    d(NCRES_P_P_P_PIZERO)            \
+    d(NCRES_P_P_P_P_PIZERO)          \
+    d(NCRES_P_P_P_P_P_PIZERO)        \
+    d(CCDIS_MU)                      \
+    d(CCDIS_MU_P)                    \
+    d(CCDIS_MU_P_P)                  \
+    d(CCDIS_MU_P_P_P)                \
+    d(CCDIS_MU_P_P_P_P)              \
+    d(CCDIS_MU_P_P_P_P_P)            \
+    d(CCDIS_MU_PIPLUS)               \
+    d(CCDIS_MU_P_PIPLUS)             \
+    d(CCDIS_MU_P_P_PIPLUS)           \
+    d(CCDIS_MU_P_P_P_PIPLUS)         \
+    d(CCDIS_MU_P_P_P_P_PIPLUS)       \
+    d(CCDIS_MU_P_P_P_P_P_PIPLUS)     \
+    d(CCDIS_MU_PHOTON)               \
+    d(CCDIS_MU_P_PHOTON)             \
+    d(CCDIS_MU_P_P_PHOTON)           \
+    d(CCDIS_MU_P_P_P_PHOTON)         \
+    d(CCDIS_MU_P_P_P_P_PHOTON)       \
+    d(CCDIS_MU_P_P_P_P_P_PHOTON)     \
+    d(CCDIS_MU_PIZERO)               \
+    d(CCDIS_MU_P_PIZERO)             \
+    d(CCDIS_MU_P_P_PIZERO)           \
+    d(CCDIS_MU_P_P_P_PIZERO)         \
+    d(CCDIS_MU_P_P_P_P_PIZERO)       \
+    d(CCDIS_MU_P_P_P_P_P_PIZERO)     \
+    d(NCDIS_P)                       \
+    d(NCDIS_P_P)                     \
+    d(NCDIS_P_P_P)                   \
+    d(NCDIS_P_P_P_P)                 \
+    d(NCDIS_P_P_P_P_P)               \
+    d(NCDIS_PIPLUS)                  \
+    d(NCDIS_P_PIPLUS)                \
+    d(NCDIS_P_P_PIPLUS)              \
+    d(NCDIS_P_P_P_PIPLUS)            \
+    d(NCDIS_P_P_P_P_PIPLUS)          \
+    d(NCDIS_P_P_P_P_P_PIPLUS)        \
+    d(NCDIS_PIMINUS)                 \
+    d(NCDIS_P_PIMINUS)               \
+    d(NCDIS_P_P_PIMINUS)             \
+    d(NCDIS_P_P_P_PIMINUS)           \
+    d(NCDIS_P_P_P_P_PIMINUS)         \
+    d(NCDIS_P_P_P_P_P_PIMINUS)       \
+    d(NCDIS_PHOTON)                  \
+    d(NCDIS_P_PHOTON)                \
+    d(NCDIS_P_P_PHOTON)              \
+    d(NCDIS_P_P_P_PHOTON)            \
+    d(NCDIS_P_P_P_P_PHOTON)          \
+    d(NCDIS_P_P_P_P_P_PHOTON)        \
+    d(NCDIS_PIZERO)                  \
+    d(NCDIS_P_PIZERO)                \
+    d(NCDIS_P_P_PIZERO)              \
+    d(NCDIS_P_P_P_PIZERO)            \
+    d(NCDIS_P_P_P_P_PIZERO)          \
+    d(NCDIS_P_P_P_P_P_PIZERO)        \
+    d(CCCOH)                         \
+    d(NCCOH)                         \
+    d(COSMIC_RAY_MU)                 \
+    d(COSMIC_RAY_P)                  \
+    d(COSMIC_RAY_E)                  \
+    d(COSMIC_RAY_PHOTON)             \
+    d(COSMIC_RAY_OTHER)              \
+    d(BEAM_PARTICLE_MU)              \
+    d(BEAM_PARTICLE_P)               \
+    d(BEAM_PARTICLE_E)               \
+    d(BEAM_PARTICLE_PHOTON)          \
+    d(BEAM_PARTICLE_PI_PLUS)         \
+    d(BEAM_PARTICLE_PI_MINUS)        \
+    d(BEAM_PARTICLE_KAON_PLUS)       \
+    d(BEAM_PARTICLE_KAON_MINUS)      \
+    d(BEAM_PARTICLE_OTHER)           \
+    d(OTHER_INTERACTION)             \
+    d(ALL_INTERACTIONS)
+
 /**
  *  @brief   InteractionType enum
  */
 enum InteractionType : int
 {
-    CCQEL_MU,
-    CCQEL_MU_P,
-    CCQEL_MU_P_P,
-    CCQEL_MU_P_P_P,
-    CCQEL_MU_P_P_P_P,
-    CCQEL_MU_P_P_P_P_P,
-    CCQEL_E,
-    CCQEL_E_P,
-    CCQEL_E_P_P,
-    CCQEL_E_P_P_P,
-    CCQEL_E_P_P_P_P,
-    CCQEL_E_P_P_P_P_P,
-    NCQEL_P,
-    NCQEL_P_P,
-    NCQEL_P_P_P,
-    NCQEL_P_P_P_P,
-    NCQEL_P_P_P_P_P,
-    CCRES_MU,
-    CCRES_MU_P,
-    CCRES_MU_P_P,
-    CCRES_MU_P_P_P,
-    CCRES_MU_P_P_P_P,
-    CCRES_MU_P_P_P_P_P,
-    CCRES_MU_PIPLUS,
-    CCRES_MU_P_PIPLUS,
-    CCRES_MU_P_P_PIPLUS,
-    CCRES_MU_P_P_P_PIPLUS,
-    CCRES_MU_P_P_P_P_PIPLUS,
-    CCRES_MU_P_P_P_P_P_PIPLUS,
-    CCRES_MU_PHOTON,
-    CCRES_MU_P_PHOTON,
-    CCRES_MU_P_P_PHOTON,
-    CCRES_MU_P_P_P_PHOTON,
-    CCRES_MU_P_P_P_P_PHOTON,
-    CCRES_MU_P_P_P_P_P_PHOTON,
-    CCRES_MU_PIZERO,
-    CCRES_MU_P_PIZERO,
-    CCRES_MU_P_P_PIZERO,
-    CCRES_MU_P_P_P_PIZERO,
-    CCRES_MU_P_P_P_P_PIZERO,
-    CCRES_MU_P_P_P_P_P_PIZERO,
-    CCRES_E,
-    CCRES_E_P,
-    CCRES_E_P_P,
-    CCRES_E_P_P_P,
-    CCRES_E_P_P_P_P,
-    CCRES_E_P_P_P_P_P,
-    CCRES_E_PIPLUS,
-    CCRES_E_P_PIPLUS,
-    CCRES_E_P_P_PIPLUS,
-    CCRES_E_P_P_P_PIPLUS,
-    CCRES_E_P_P_P_P_PIPLUS,
-    CCRES_E_P_P_P_P_P_PIPLUS,
-    CCRES_E_PHOTON,
-    CCRES_E_P_PHOTON,
-    CCRES_E_P_P_PHOTON,
-    CCRES_E_P_P_P_PHOTON,
-    CCRES_E_P_P_P_P_PHOTON,
-    CCRES_E_P_P_P_P_P_PHOTON,
-    CCRES_E_PIZERO,
-    CCRES_E_P_PIZERO,
-    CCRES_E_P_P_PIZERO,
-    CCRES_E_P_P_P_PIZERO,
-    CCRES_E_P_P_P_P_PIZERO,
-    CCRES_E_P_P_P_P_P_PIZERO,
-    NCRES_P,
-    NCRES_P_P,
-    NCRES_P_P_P,
-    NCRES_P_P_P_P,
-    NCRES_P_P_P_P_P,
-    NCRES_PIPLUS,
-    NCRES_P_PIPLUS,
-    NCRES_P_P_PIPLUS,
-    NCRES_P_P_P_PIPLUS,
-    NCRES_P_P_P_P_PIPLUS,
-    NCRES_P_P_P_P_P_PIPLUS,
-    NCRES_PIMINUS,
-    NCRES_P_PIMINUS,
-    NCRES_P_P_PIMINUS,
-    NCRES_P_P_P_PIMINUS,
-    NCRES_P_P_P_P_PIMINUS,
-    NCRES_P_P_P_P_P_PIMINUS,
-    NCRES_PHOTON,
-    NCRES_P_PHOTON,
-    NCRES_P_P_PHOTON,
-    NCRES_P_P_P_PHOTON,
-    NCRES_P_P_P_P_PHOTON,
-    NCRES_P_P_P_P_P_PHOTON,
-    NCRES_PIZERO,
-    NCRES_P_PIZERO,
-    NCRES_P_P_PIZERO,
-    NCRES_P_P_P_PIZERO,
-    NCRES_P_P_P_P_PIZERO,
-    NCRES_P_P_P_P_P_PIZERO,
-    CCDIS_MU,
-    CCDIS_MU_P,
-    CCDIS_MU_P_P,
-    CCDIS_MU_P_P_P,
-    CCDIS_MU_P_P_P_P,
-    CCDIS_MU_P_P_P_P_P,
-    CCDIS_MU_PIPLUS,
-    CCDIS_MU_P_PIPLUS,
-    CCDIS_MU_P_P_PIPLUS,
-    CCDIS_MU_P_P_P_PIPLUS,
-    CCDIS_MU_P_P_P_P_PIPLUS,
-    CCDIS_MU_P_P_P_P_P_PIPLUS,
-    CCDIS_MU_PHOTON,
-    CCDIS_MU_P_PHOTON,
-    CCDIS_MU_P_P_PHOTON,
-    CCDIS_MU_P_P_P_PHOTON,
-    CCDIS_MU_P_P_P_P_PHOTON,
-    CCDIS_MU_P_P_P_P_P_PHOTON,
-    CCDIS_MU_PIZERO,
-    CCDIS_MU_P_PIZERO,
-    CCDIS_MU_P_P_PIZERO,
-    CCDIS_MU_P_P_P_PIZERO,
-    CCDIS_MU_P_P_P_P_PIZERO,
-    CCDIS_MU_P_P_P_P_P_PIZERO,
-    NCDIS_P,
-    NCDIS_P_P,
-    NCDIS_P_P_P,
-    NCDIS_P_P_P_P,
-    NCDIS_P_P_P_P_P,
-    NCDIS_PIPLUS,
-    NCDIS_P_PIPLUS,
-    NCDIS_P_P_PIPLUS,
-    NCDIS_P_P_P_PIPLUS,
-    NCDIS_P_P_P_P_PIPLUS,
-    NCDIS_P_P_P_P_P_PIPLUS,
-    NCDIS_PIMINUS,
-    NCDIS_P_PIMINUS,
-    NCDIS_P_P_PIMINUS,
-    NCDIS_P_P_P_PIMINUS,
-    NCDIS_P_P_P_P_PIMINUS,
-    NCDIS_P_P_P_P_P_PIMINUS,
-    NCDIS_PHOTON,
-    NCDIS_P_PHOTON,
-    NCDIS_P_P_PHOTON,
-    NCDIS_P_P_P_PHOTON,
-    NCDIS_P_P_P_P_PHOTON,
-    NCDIS_P_P_P_P_P_PHOTON,
-    NCDIS_PIZERO,
-    NCDIS_P_PIZERO,
-    NCDIS_P_P_PIZERO,
-    NCDIS_P_P_P_PIZERO,
-    NCDIS_P_P_P_P_PIZERO,
-    NCDIS_P_P_P_P_P_PIZERO,
-    CCCOH,
-    NCCOH,
-    COSMIC_RAY_MU,
-    COSMIC_RAY_P,
-    COSMIC_RAY_E,
-    COSMIC_RAY_PHOTON,
-    COSMIC_RAY_OTHER,
-    BEAM_PARTICLE_MU,
-    BEAM_PARTICLE_P,
-    BEAM_PARTICLE_E,
-    BEAM_PARTICLE_PHOTON,
-    BEAM_PARTICLE_PI_PLUS,
-    BEAM_PARTICLE_PI_MINUS,
-    BEAM_PARTICLE_KAON_PLUS,
-    BEAM_PARTICLE_KAON_MINUS,
-    BEAM_PARTICLE_OTHER,
-    OTHER_INTERACTION,
-    ALL_INTERACTIONS
+    INTERACTION_TYPE_TABLE(GET_ENUM_ENTRY)
 };
 
+constexpr int N_INTERACTION_TYPES(0 INTERACTION_TYPE_TABLE(GET_ENUM_COUNT));
+
 /**
  *  @brief  Get a string representation of an interaction type
  *
@@ -410,6 +632,66 @@ std::string ToString(const InteractionType interactionType);
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+/**
+ *  @brief  DenseEnumMap class template, a map keyed on a small, dense enum, held as an array indexed by the enum so that lookups are array
+ *          accesses rather than tree searches. As for a std::map, only keys that have been accessed are present, in enum order. Keys outside
+ *          the enum range (e.g. interaction types added to LArContent after this table) share a final slot, at index N_KEYS, reported as
+ *          UNKNOWN.
+ */
+template <typename KEY, typename VALUE, int N_KEYS>
+class DenseEnumMap
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    DenseEnumMap();
+
+    /**
+     *  @brief  Get the value for a key, adding a default value if the key is not present
+     *
+     *  @param  key the key
+     *
+     *  @return the value
+     */
+    VALUE &operator[](const KEY key);
+
+    /**
+     *  @brief  Get the value for a key
+     *
+     *  @param  key the key
+     *
+     *  @return the value, throwing if the key is not present
+     */
+    const VALUE &At(const KEY key) const;
+
+    /**
+     *  @brief  Whether a key is present
+     *
+     *  @param  key the key
+     *
+     *  @return boolean
+     */
+    bool Contains(const KEY key) const;
+
+    static constexpr int        m_nSlots = N_KEYS + 1;  ///< The number of slots, one per key and then one for keys outside the enum range
+
+private:
+    /**
+     *  @brief  Get the slot for a key
+     *
+     *  @param  key the key
+     *
+     *  @return the slot index, N_KEYS for keys outside the enum range
+     */
+    static int GetSlot(const KEY key);
+
+    std::array<VALUE, m_nSlots> m_values;               ///< The values, indexed by slot
+    std::array<bool, m_nSlots>  m_isPresent;            ///< Whether each slot is present
+};
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 /**
  * @brief   CountingDetails class
  */
@@ -429,8 +711,8 @@ public:
     unsigned int            m_correctId;                ///< The number of times the mc primary particle id was correct
 };
 
-typedef std::map<ExpectedPrimary, CountingDetails> CountingMap;
-typedef std::map<InteractionType, CountingMap> InteractionCountingMap;
+typedef DenseEnumMap<ExpectedPrimary, CountingDetails, N_EXPECTED_PRIMARIES> CountingMap;
+typedef DenseEnumMap<InteractionType, CountingMap, N_INTERACTION_TYPES> InteractionCountingMap;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -455,7 +737,7 @@ public:
     float                   m_trueMomentum;             ///< The true momentum of the mc primary
 };
 
-typedef std::map<ExpectedPrimary, PrimaryResult> PrimaryResultMap;
+typedef DenseEnumMap<ExpectedPrimary, PrimaryResult, N_EXPECTED_PRIMARIES> PrimaryResultMap;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -479,7 +761,28 @@ public:
 };
 
 typedef std::vector<TargetResult> TargetResultList; // ATTN Not terribly efficient, but that's not the main aim here
-typedef std::map<InteractionType, TargetResultList> InteractionTargetResultMap;
+typedef DenseEnumMap<InteractionType, TargetResultList, N_INTERACTION_TYPES> InteractionTargetResultMap;
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief   ValidationAccumulator class, the results accumulated over a range of events
+ */
+class ValidationAccumulator
+{
+public:
+    /**
+     *  @brief  Default constructor
+     */
+    ValidationAccumulator();
+
+    InteractionCountingMap      m_interactionCountingMap;       ///< The interaction counting map
+    InteractionTargetResultMap  m_interactionTargetResultMap;   ///< The interaction target result map
+    long long                   m_nEntriesRead;                 ///< The number of chain entries read
+    int                         m_nEvents;                      ///< The number of events read
+};
+
+typedef std::vector<ValidationAccumulator> ValidationAccumulatorList;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -502,7 +805,7 @@ public:
     TH1F                   *m_hVtxDeltaR;               ///< The vtx delta r histogram
 };
 
-typedef std::map<InteractionType, TargetHistogramCollection> InteractionTargetHistogramMap;
+typedef DenseEnumMap<InteractionType, TargetHistogramCollection, N_INTERACTION_TYPES> InteractionTargetHistogramMap;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -525,8 +828,8 @@ public:
     TH1F                   *m_hPurity;                  ///< The primary (best match) purity histogram
 };
 
-typedef std::map<ExpectedPrimary, PrimaryHistogramCollection> PrimaryHistogramMap;
-typedef std::map<InteractionType, PrimaryHistogramMap> InteractionPrimaryHistogramMap;
+typedef DenseEnumMap<ExpectedPrimary, PrimaryHistogramCollection, N_EXPECTED_PRIMARIES> PrimaryHistogramMap;
+typedef DenseEnumMap<InteractionType, PrimaryHistogramMap, N_INTERACTION_TYPES> InteractionPrimaryHistogramMap;
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -539,16 +842,49 @@ typedef std::map<InteractionType, PrimaryHistogramMap> InteractionPrimaryHistogr
 void Validation(const std::string &inputFiles, const Parameters &parameters = Parameters());
 
 /**
- *  @brief  Read the next event from the chain
+ *  @brief  Validation - Main entry point for analysis of several sets of input files
+ *
+ *  @param  inputFilesList the list of regexes identifying the input root files
+ *  @param  parameters the parameters
+ */
+void Validation(const std::vector<std::string> &inputFilesList, const Parameters &parameters = Parameters());
+
+/**
+ *  @brief  Process the events in a chain, accumulating the matching results for those within the range selected by the parameters
  *
  *  @param  pTChain the address of the chain
- *  @param  iEntry the first chain entry to read
- *  @param  simpleMCEvent the event to be populated
  *  @param  parameters the parameters
+ *  @param  firstEventIndex the index of the first event in the chain, within the full list of input events
+ *  @param  accumulator the accumulator, to be populated
+ */
+void ProcessEvents(TChain *const pTChain, const Parameters &parameters, const int firstEventIndex, ValidationAccumulator &accumulator);
+
+/**
+ *  @brief  Process the events in the input files using a pool of worker threads, each processing whole files into its own accumulators, which
+ *          are then merged in input file order, so the results match those of serial processing
  *
- *  @return the number of chain entries read
+ *  @param  pTChain the address of the chain of input files
+ *  @param  parameters the parameters
+ *  @param  accumulator the accumulator, to be populated
  */
-int ReadNextEvent(TChain *const pTChain, const int iEntry, SimpleMCEvent &simpleMCEvent, const Parameters &parameters);
+void ProcessEventsMultiThreaded(TChain *const pTChain, const Parameters &parameters, ValidationAccumulator &accumulator);
+
+/**
+ *  @brief  Count the events in a chain, reading only the event numbers
+ *
+ *  @param  pTChain the address of the chain
+ *
+ *  @return the number of events
+ */
+int CountEvents(TChain *const pTChain);
+
+/**
+ *  @brief  Merge the results in one accumulator into another, appending target results after those already present
+ *
+ *  @param  input the accumulator to merge
+ *  @param  output the accumulator into which to merge
+ */
+void MergeAccumulators(const ValidationAccumulator &input, ValidationAccumulator &output);
 
 /**
  *  @brief  Print matching details to screen for a simple mc event
@@ -563,60 +899,71 @@ void DisplaySimpleMCEventMatches(const SimpleMCEvent &simpleMCEvent, const Param
  *
  *  @param  simpleMCEvent the simple mc event
  *  @param  parameters the parameters
+ *  @param  matchingColumns the matching columns, reused across events
  *  @param  interactionCountingMap the interaction counting map, to be populated
  *  @param  interactionTargetResultMap the interaction target outcome map, to be populated
  */
-void CountPfoMatches(const SimpleMCEvent &simpleMCEvent, const Parameters &parameters, InteractionCountingMap &interactionCountingMap,
-    InteractionTargetResultMap &interactionTargetResultMap);
+void CountPfoMatches(const SimpleMCEvent &simpleMCEvent, const Parameters &parameters, MatchingColumns &matchingColumns,
+    InteractionCountingMap &interactionCountingMap, InteractionTargetResultMap &interactionTargetResultMap);
 
 /**
- *  @brief  Whether a simple mc event passes the relevant fiducial cut, applied to target vertices
+ *  @brief  Fill the matching columns for a simple mc event, in passes over its target and primary columns
  *
- *  @param  simpleMCTarget the simple mc target
+ *  @param  simpleMCEvent the simple mc event
  *  @param  parameters the parameters
+ *  @param  matchingColumns the matching columns, to be populated
+ */
+void FillMatchingColumns(const SimpleMCEvent &simpleMCEvent, const Parameters &parameters, MatchingColumns &matchingColumns);
+
+/**
+ *  @brief  Whether the targets of a simple mc event pass the relevant fiducial cut, applied to target vertices
  *
- *  @return boolean
+ *  @param  simpleMCEvent the simple mc event
+ *  @param  parameters the parameters
+ *  @param  passFiducialCut to receive whether each target passes the cut
  */
-bool PassFiducialCut(const SimpleMCTarget &simpleMCTarget, const Parameters &parameters);
+void PassFiducialCut(const SimpleMCEvent &simpleMCEvent, const Parameters &parameters, IntVector &passFiducialCut);
 
 /**
- *  @brief  Whether a simple mc event passes uboone fiducial cut, applied to target vertices
+ *  @brief  Whether a target vertex passes uboone fiducial cut
  *
- *  @param  simpleMCTarget the simple mc target
+ *  @param  x the target vertex x position
+ *  @param  y the target vertex y position
+ *  @param  z the target vertex z position
  *
  *  @return boolean
  */
-bool PassUbooneFiducialCut(const SimpleMCTarget &simpleMCTarget);
+bool PassUbooneFiducialCut(const float x, const float y, const float z);
 
 /**
- *  @brief  Whether a simple mc event passes sbnd fiducial cut, applied to target vertices
+ *  @brief  Whether a target vertex passes sbnd fiducial cut
  *
- *  @param  simpleMCTarget the simple mc target
+ *  @param  x the target vertex x position
+ *  @param  y the target vertex y position
+ *  @param  z the target vertex z position
  *
  *  @return boolean
  */
-bool PassSBNDFiducialCut(const SimpleMCTarget &simpleMCTarget);
+bool PassSBNDFiducialCut(const float x, const float y, const float z);
 
 /**
- *  @brief  Work out which of the primary particles (expected for a given interaction types) corresponds to the provided primary id
+ *  @brief  Work out which of the primary particles (expected for a given interaction types) corresponds to each primary of each target
  *          ATTN: Relies on fact that primary list is sorted by number of true hits
  *
- *  @param  simpleMCPrimary the simple mc primary
- *  @param  simpleMCPrimaryList the simple mc primary list
- *
- *  @return the expected primary
+ *  @param  simpleMCEvent the simple mc event
+ *  @param  expectedPrimaries to receive the expected primary for each primary
  */
-ExpectedPrimary GetExpectedPrimary(const SimpleMCPrimary &simpleMCPrimary, const SimpleMCPrimaryList &simpleMCPrimaryList);
+void GetExpectedPrimaries(const SimpleMCEvent &simpleMCEvent, IntVector &expectedPrimaries);
 
 /**
  *  @brief  Whether a provided mc primary and best matched pfo are deemed to have a good particle id match
  *
- *  @param  simpleMCPrimary the simple mc primary
+ *  @param  mcPdgCode the mc primary pdg code
  *  @param  bestMatchPfoPdgCode the best matched pfo pdg code
  *
  *  @return boolean
  */
-bool IsGoodParticleIdMatch(const SimpleMCPrimary &simpleMCPrimary, const int bestMatchPfoPdgCode);
+bool IsGoodParticleIdMatch(const int mcPdgCode, const int bestMatchPfoPdgCode);
 
 /**
  *  @brief  Print details to screen for a provided interaction type to counting map
@@ -673,7 +1020,8 @@ Parameters::Parameters() :
     m_vertexXCorrection(0.495694f),
     m_histogramOutput(false),
     m_testBeamMode(false),
-    m_triggeredBeamOnly(true)
+    m_triggeredBeamOnly(true),
+    m_nThreads(1)
 {
 }
 
@@ -713,40 +1061,65 @@ SimpleThreeVector operator+(const SimpleThreeVector &lhs, const SimpleThreeVecto
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-SimpleMCPrimary::SimpleMCPrimary() :
-    m_primaryId(-1),
-    m_pdgCode(0),
-    m_energy(0.f),
-    m_momentum(0.f, 0.f, 0.f),
-    m_vertex(-1.f, -1.f, -1.f),
-    m_endpoint(-1.f, -1.f, -1.f),
-    m_nMCHitsTotal(0),
-    m_nMCHitsU(0),
-    m_nMCHitsV(0),
-    m_nMCHitsW(0),
-    m_nPrimaryMatchedPfos(0),
-    m_nPrimaryMatchedNuPfos(0),
-    m_nPrimaryMatchedCRPfos(0),
-    m_bestMatchPfoId(-1),
-    m_bestMatchPfoPdgCode(0),
-    m_bestMatchPfoIsRecoNu(0),
-    m_bestMatchPfoRecoNuId(-1),
-    m_bestMatchPfoIsTestBeam(0),
-    m_bestMatchPfoNHitsTotal(0),
-    m_bestMatchPfoNHitsU(0),
-    m_bestMatchPfoNHitsV(0),
-    m_bestMatchPfoNHitsW(0),
-    m_bestMatchPfoNSharedHitsTotal(0),
-    m_bestMatchPfoNSharedHitsU(0),
-    m_bestMatchPfoNSharedHitsV(0),
-    m_bestMatchPfoNSharedHitsW(0)
+void SimpleMCPrimaryColumns::Clear()
+{
+    for (IntVector *const pIntVector : {&m_primaryId, &m_pdgCode, &m_nMCHitsTotal, &m_nMCHitsU, &m_nMCHitsV, &m_nMCHitsW, &m_nPrimaryMatchedPfos,
+        &m_nPrimaryMatchedNuPfos, &m_nPrimaryMatchedCRPfos, &m_bestMatchPfoId, &m_bestMatchPfoPdgCode, &m_bestMatchPfoIsRecoNu, &m_bestMatchPfoRecoNuId,
+        &m_bestMatchPfoIsTestBeam, &m_bestMatchPfoNHitsTotal, &m_bestMatchPfoNHitsU, &m_bestMatchPfoNHitsV, &m_bestMatchPfoNHitsW,
+        &m_bestMatchPfoNSharedHitsTotal, &m_bestMatchPfoNSharedHitsU, &m_bestMatchPfoNSharedHitsV, &m_bestMatchPfoNSharedHitsW})
+    {
+        pIntVector->clear();
+    }
+
+    for (FloatVector *const pFloatVector : {&m_energy, &m_momentumX, &m_momentumY, &m_momentumZ, &m_vertexX, &m_vertexY, &m_vertexZ, &m_endpointX,
+        &m_endpointY, &m_endpointZ})
+    {
+        pFloatVector->clear();
+    }
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SimpleMCTargetColumns::Clear()
+{
+    for (IntVector *const pIntVector : {&m_interactionType, &m_mcNuanceCode, &m_isNeutrino, &m_isBeamParticle, &m_isCosmicRay, &m_isCorrectNu,
+        &m_isCorrectTB, &m_isCorrectCR, &m_isFakeNu, &m_isFakeCR, &m_isSplitNu, &m_isSplitCR, &m_isLost, &m_nTargetMatches, &m_nTargetNuMatches,
+        &m_nTargetCRMatches, &m_nTargetGoodNuMatches, &m_nTargetNuSplits, &m_nTargetNuLosses})
+    {
+        pIntVector->clear();
+    }
+
+    for (FloatVector *const pFloatVector : {&m_targetVertexX, &m_targetVertexY, &m_targetVertexZ, &m_recoVertexX, &m_recoVertexY, &m_recoVertexZ})
+        pFloatVector->clear();
+
+    m_primaryBegin.assign(1, 0);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+SimpleMCEvent::SimpleMCEvent() :
+    m_fileIdentifier(-1),
+    m_eventNumber(0),
+    m_nMCTargets(0)
 {
+    m_targets.m_primaryBegin.assign(1, 0);
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+void SimpleMCEvent::Clear()
+{
+    m_nMCTargets = 0;
+    m_targets.Clear();
+    m_primaries.Clear();
 }
 
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-SimpleMCTarget::SimpleMCTarget() :
+ValidationTreeReader::TargetEntry::TargetEntry() :
     m_interactionType(OTHER_INTERACTION),
     m_mcNuanceCode(0),
     m_isNeutrino(false),
@@ -775,16 +1148,6 @@ SimpleMCTarget::SimpleMCTarget() :
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
-SimpleMCEvent::SimpleMCEvent() :
-    m_fileIdentifier(-1),
-    m_eventNumber(0),
-    m_nMCTargets(0)
-{
-}
-
-//------------------------------------------------------------------------------------------------------------------------------------------
-//------------------------------------------------------------------------------------------------------------------------------------------
-
 CountingDetails::CountingDetails() :
     m_nTotal(0),
     m_nMatch0(0),
@@ -813,6 +1176,53 @@ PrimaryResult::PrimaryResult() :
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+template <typename KEY, typename VALUE, int N_KEYS>
+inline DenseEnumMap<KEY, VALUE, N_KEYS>::DenseEnumMap() :
+    m_values(),
+    m_isPresent()
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename KEY, typename VALUE, int N_KEYS>
+inline VALUE &DenseEnumMap<KEY, VALUE, N_KEYS>::operator[](const KEY key)
+{
+    const int slot(DenseEnumMap::GetSlot(key));
+    m_isPresent[slot] = true;
+    return m_values[slot];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename KEY, typename VALUE, int N_KEYS>
+inline const VALUE &DenseEnumMap<KEY, VALUE, N_KEYS>::At(const KEY key) const
+{
+    if (!this->Contains(key))
+        throw std::out_of_range("DenseEnumMap - key " + std::to_string(static_cast<int>(key)) + " not present");
+
+    return m_values[DenseEnumMap::GetSlot(key)];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename KEY, typename VALUE, int N_KEYS>
+inline bool DenseEnumMap<KEY, VALUE, N_KEYS>::Contains(const KEY key) const
+{
+    return m_isPresent[DenseEnumMap::GetSlot(key)];
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+
+template <typename KEY, typename VALUE, int N_KEYS>
+inline int DenseEnumMap<KEY, VALUE, N_KEYS>::GetSlot(const KEY key)
+{
+    return ((key >= 0) && (key < N_KEYS)) ? static_cast<int>(key) : N_KEYS;
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 TargetResult::TargetResult() :
     m_fileIdentifier(-1),
     m_eventNumber(-1),
@@ -825,6 +1235,15 @@ TargetResult::TargetResult() :
 //------------------------------------------------------------------------------------------------------------------------------------------
 //------------------------------------------------------------------------------------------------------------------------------------------
 
+ValidationAccumulator::ValidationAccumulator() :
+    m_nEntriesRead(0),
+    m_nEvents(0)
+{
+}
+
+//------------------------------------------------------------------------------------------------------------------------------------------
+//------------------------------------------------------------------------------------------------------------------------------------------
+
 PrimaryHistogramCollection::PrimaryHistogramCollection() :
     m_hHitsAll(nullptr),
     m_hHitsEfficiency(nullptr),